@@ -7,6 +7,7 @@
   Rico Haas (3310344)  
   */
 
+#include "binlog.h"
 #include "driver/gpio.h"
 #include "esp_chip_info.h"
 #include "esp_flash.h"
@@ -68,7 +69,7 @@ static void useless_load(TaskParams *params, TickType_t duration) {
     //we are storing it in next_wake_time to ensure the task's timings and precise delays
     TickType_t next_wake_time = xTaskGetTickCount();
 
-    printf("EXEC: Task %d (%ld/%ld)\n", params->id, params->elapsed_time + 1,params->execution_time);
+    BINLOG("EXEC: Task %d (%ld/%ld)\n", params->id, params->elapsed_time + 1,params->execution_time);
 
     for (j = 0; j < mainBLINK_PER_TICK; ++j) {//controls how many blinks happen per system tick 
       //vTaskDelayUntil() specifies the absolute (exact) time at which it wishes to unblock.
@@ -167,6 +168,9 @@ void app_main(void) {
   useless_load_semaphore = xSemaphoreCreateBinary();
   xSemaphoreGive(useless_load_semaphore);
 
+  // log without blocking on the UART from the tasks
+  binlog_start(tskIDLE_PRIORITY);
+
    xTaskCreate(chatterbox_task,"Task 1", 2048, &task1_params, mainTASK_CHATTERBOX_TASK1_PRIORITY, NULL);
    xTaskCreate(chatterbox_task,"Task 2", 2048, &task2_params, mainTASK_CHATTERBOX_TASK2_PRIORITY, NULL);
    xTaskCreate(chatterbox_task,"Task 3", 2048, &task3_params, mainTASK_CHATTERBOX_TASK3_PRIORITY, NULL);
@@ -0,0 +1,247 @@
+#include "admission.h"
+
+typedef struct {
+  TaskParams *params;  // identifies the task, owned by the caller
+  TaskParams reserved; // parameters the admission decisions are based on
+  TaskHandle_t handle;
+  bool remove_pending;
+} AdmittedTask;
+
+// admitted tasks ordered by decreasing priority (shortest period first)
+static AdmittedTask admitted[MAX_ADMITTED_TASKS];
+static unsigned int number_of_admitted;
+
+// running sums of the Q16 utilizations rounded up and down, respectively
+static uint64_t utilization_up;
+static uint64_t utilization_down;
+// number of admitted tasks with deadline != period
+static unsigned int explicit_deadlines;
+
+static SemaphoreHandle_t admission_mutex;
+static unsigned long stage_hits[NUMBER_OF_STAGES];
+
+static q16_t utilization_q16_down(TickType_t execution_time,
+                                  TickType_t period) {
+  return (q16_t)(((uint64_t)execution_time << 16) / period);
+}
+
+static void account(TaskParams *task, int sign) {
+  utilization_up += sign * (int64_t)utilization_q16(task->execution_time,
+                                                    task->period);
+  utilization_down += sign * (int64_t)utilization_q16_down(
+                                 task->execution_time, task->period);
+  if (task->deadline != task->period)
+    explicit_deadlines += sign;
+}
+
+static int find_task(const TaskParams *params) {
+  for (unsigned int i = 0; i < number_of_admitted; i++) {
+    if (admitted[i].params == params)
+      return i;
+  }
+  return -1;
+}
+
+// Priorities follow the position in 'admitted', starting with 'first'
+static void assign_priorities(unsigned int first) {
+  for (unsigned int i = first; i < number_of_admitted; i++) {
+    vTaskPrioritySet(admitted[i].handle,
+                     tskIDLE_PRIORITY + MAX_ADMITTED_TASKS - i);
+  }
+}
+
+/* Priority ordered view of the admitted tasks without admitted[skip] (if
+ * skip >= 0) and with 'task' inserted. Returns the number of tasks in the
+ * view, 'position' is set to the index of 'task'. */
+static unsigned int build_view(TaskParams *task, int skip, TaskParams **view,
+                               unsigned int *position) {
+  unsigned int count = 0;
+  bool inserted = false;
+  for (unsigned int i = 0; i < number_of_admitted; i++) {
+    if ((int)i == skip)
+      continue;
+    if (!inserted && task->period < admitted[i].reserved.period) {
+      *position = count;
+      view[count++] = task;
+      inserted = true;
+    }
+    view[count++] = &admitted[i].reserved;
+  }
+  if (!inserted) {
+    *position = count;
+    view[count++] = task;
+  }
+  return count;
+}
+
+/* Admission decision for 'task' replacing admitted[skip] (or a new task if
+ * skip < 0). The running sums must already include 'task'. */
+static bool admission_test(TaskParams *task, int skip, unsigned int *position,
+                           AcceptanceTestResult *result) {
+  TaskParams *view[MAX_ADMITTED_TASKS + 1];
+  unsigned int count = build_view(task, skip, view, position);
+
+  *result = default_result;
+  result->task_info.util = (double)utilization_up / Q16_ONE;
+
+  // O(1) necessary condition
+  if (utilization_down > Q16_ONE)
+    return false;
+
+  // O(1) sufficient condition, the Liu & Layland bound decreases with n
+  if (explicit_deadlines == 0 &&
+      utilization_up <= utilization_bound_q16(count, 1, 1)) {
+    stage_hits[STAGE_UTILIZATION_BOUND]++;
+    result->accepted = true;
+    return true;
+  }
+
+  // Only the task and the tasks below it see a different interference
+  unsigned int first = *position;
+  if (skip >= 0 && (unsigned int)skip < first)
+    first = skip;
+  for (unsigned int i = first; i < count; i++) {
+    AcceptanceTestResult task_result = default_result;
+    acceptance_test(view, i, &task_result);
+    stage_hits[task_result.stage]++;
+    if (i == *position)
+      *result = task_result;
+    if (!task_result.accepted) {
+      result->accepted = false;
+      return false;
+    }
+  }
+  return true;
+}
+
+void admission_setup() {
+  number_of_admitted = 0;
+  utilization_up = 0;
+  utilization_down = 0;
+  explicit_deadlines = 0;
+  for (unsigned int i = 0; i < NUMBER_OF_STAGES; i++) {
+    stage_hits[i] = 0;
+  }
+  admission_mutex = xSemaphoreCreateMutex();
+}
+
+bool admission_add(TaskParams *params, AcceptanceTestResult *result) {
+  unsigned int position;
+
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  if (number_of_admitted == MAX_ADMITTED_TASKS || find_task(params) >= 0) {
+    *result = default_result;
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  account(params, 1);
+  if (!admission_test(params, -1, &position, result)) {
+    account(params, -1);
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  for (unsigned int i = number_of_admitted; i > position; i--) {
+    admitted[i] = admitted[i - 1];
+  }
+  admitted[position] = (AdmittedTask){.params = params, .reserved = *params};
+  number_of_admitted++;
+
+  char task_name[6];
+  snprintf(task_name, 6, "task%c", params->id);
+  xTaskCreate((void *)task_implementation, task_name,
+              configMINIMAL_STACK_SIZE + 256, params,
+              tskIDLE_PRIORITY + MAX_ADMITTED_TASKS - position,
+              &admitted[position].handle);
+  assign_priorities(position + 1);
+  xSemaphoreGive(admission_mutex);
+  return true;
+}
+
+void admission_stage_hits(unsigned long *hits) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  for (unsigned int i = 0; i < NUMBER_OF_STAGES; i++) {
+    hits[i] = stage_hits[i];
+  }
+  xSemaphoreGive(admission_mutex);
+}
+
+bool admission_remove(TaskParams *params) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  int index = find_task(params);
+  if (index >= 0)
+    admitted[index].remove_pending = true;
+  xSemaphoreGive(admission_mutex);
+  return index >= 0;
+}
+
+bool admission_update(TaskParams *params, TickType_t execution_time,
+                      TickType_t period, TickType_t deadline,
+                      AcceptanceTestResult *result) {
+  unsigned int position;
+
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  int index = find_task(params);
+  if (index < 0 || admitted[index].remove_pending) {
+    *result = default_result;
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  TaskParams updated = admitted[index].reserved;
+  updated.execution_time = execution_time;
+  updated.period = period;
+  updated.deadline = deadline;
+
+  account(&admitted[index].reserved, -1);
+  account(&updated, 1);
+  if (!admission_test(&updated, index, &position, result)) {
+    account(&updated, -1);
+    account(&admitted[index].reserved, 1);
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  // move the task to its new priority
+  AdmittedTask entry = admitted[index];
+  entry.reserved = updated;
+  for (unsigned int i = index; i + 1 < number_of_admitted; i++) {
+    admitted[i] = admitted[i + 1];
+  }
+  for (unsigned int i = number_of_admitted - 1; i > position; i--) {
+    admitted[i] = admitted[i - 1];
+  }
+  admitted[position] = entry;
+  assign_priorities(position < (unsigned int)index ? position : index);
+  xSemaphoreGive(admission_mutex);
+  return true;
+}
+
+bool admission_job_complete(const TaskParams *params,
+                            TaskParams *next_job) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  int index = find_task(params);
+  if (index < 0) {
+    xSemaphoreGive(admission_mutex);
+    return true;
+  }
+
+  if (admitted[index].remove_pending) {
+    account(&admitted[index].reserved, -1);
+    for (unsigned int i = index; i + 1 < number_of_admitted; i++) {
+      admitted[i] = admitted[i + 1];
+    }
+    number_of_admitted--;
+    // all tasks below the removed one move up by one priority level
+    assign_priorities(index);
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  next_job->execution_time = admitted[index].reserved.execution_time;
+  next_job->period = admitted[index].reserved.period;
+  next_job->deadline = admitted[index].reserved.deadline;
+  xSemaphoreGive(admission_mutex);
+  return true;
+}
@@ -0,0 +1,48 @@
+#ifndef TDA_ADMISSION_H
+#define TDA_ADMISSION_H
+
+#include "analysis.h"
+#include "tasks.h"
+
+#define MAX_ADMITTED_TASKS 8
+
+/* Runtime admission control for rate monotonic scheduling.
+ * The admitted tasks are kept in priority order together with running sums
+ * of their utilization, so most decisions are O(1):
+ *  - the task set is rejected if its utilization exceeds 1,
+ *  - it is accepted if all deadlines equal the periods and the utilization
+ *    stays below the Liu & Layland bound.
+ * Otherwise, acceptance_test is rerun only for the tasks whose interference
+ * changed, i.e., the new/updated task and all tasks of lower priority.
+ * Removals and updates take effect once the current job of the task is
+ * complete (see admission_job_complete). */
+
+void admission_setup();
+
+/* Admit 'params' and create its task with the rate monotonic priority.
+ * The caller keeps ownership of 'params'; it has to stay valid until the
+ * task is removed. */
+bool admission_add(TaskParams *params, AcceptanceTestResult *result);
+
+/* Request the removal of an admitted task. Removing a task never increases
+ * the interference of the others, so no test is needed. */
+bool admission_remove(TaskParams *params);
+
+/* Change the parameters of an admitted task. The decision is based on the
+ * new parameters right away, the task uses them after its current job. */
+bool admission_update(TaskParams *params, TickType_t execution_time,
+                      TickType_t period, TickType_t deadline,
+                      AcceptanceTestResult *result);
+
+/* Copy the number of decisions made by each stage of acceptance_test into
+ * 'hits' (NUMBER_OF_STAGES entries). O(1) accepts count as utilization bound
+ * decisions, O(1) rejects (utilization above 1) are not counted. */
+void admission_stage_hits(unsigned long *hits);
+
+/* Called by every admitted task after each job. Returns false if the task
+ * was removed and has to delete itself. Otherwise, pending updates are
+ * applied to 'next_job', the task's own copy of its parameters; 'params'
+ * only identifies the task and is left alone. */
+bool admission_job_complete(const TaskParams *params, TaskParams *next_job);
+
+#endif
@@ -0,0 +1,470 @@
+#include "analysis.h"
+#include "simulation.h"
+#include <math.h>
+
+AcceptanceTestResult default_result = {false, default_task_info,
+                                       STAGE_UTILIZATION_BOUND};
+const char *const acceptance_stage_names[NUMBER_OF_STAGES] = {
+    "UB", "HB", "Harmonic", "WCS", "TDA", "SIM"};
+
+TickType_t div_ceil(TickType_t x, TickType_t y) { return x / y + (x % y != 0); }
+
+/* Maximum allowable utilization of n tasks under RMS, where the task under
+ * consideration has a relative deadline of Delta * period. */
+static double utilization_bound(unsigned int n, TaskParams *task) {
+    double delta = (double)task->deadline / task->period; // Calculate Delta where deadline = Delta . period
+
+    // Use the correct equation according to the relative deadline
+    if(delta <= 0.5){
+      return delta;
+    }
+    else if(delta <= 1){
+      // return n * (pow(2, 1.0 / n) - 1); // IF deadline = period (delta = 1)
+      return n * ( pow(2*delta, 1.0 / n) - 1) + 1 - delta;
+    }
+    else{
+      return delta * (n) * ( pow( (delta + 1)/delta, 1.0/(n) ) - 1); // n is used instead of n-1 to get the same numbers as in the table in the lecture
+    }
+}
+
+void utilization_bound_test(TaskParams **params, unsigned int task_id,
+                            AcceptanceTestResult *result) {
+    double utilization = 0;
+    bool accepted = false;  
+
+    /*--------------------------------------------------------------------
+     * Subtask 1: Implement the Utilization Bound Test from the lecture
+     * The goal is to determine if all tasks up to and including the task
+     * with ID `task_id` are schedulable under Rate Monotonic Scheduling.
+     ---------------------------------------------------------------------*/
+
+    /* --- START~Solution --- */
+    for (unsigned int i = 0; i <= task_id; ++i) {
+        // Calculate the cumulative utilization of all tasks up to task_id.
+        // Utilization of a task: execution_time / period.
+        utilization += (double)params[i]->execution_time / params[i]->period;
+    }
+
+    // Calculate the utilization bound for n tasks:
+    // n = number of tasks, which is task_id + 1 (since task_id is zero-based).
+    unsigned int n = task_id + 1;
+    double util_max = utilization_bound(n, params[task_id]);
+
+    // Determine if the task set is schedulable.
+    // If cumulative utilization <= maximum allowable utilization, accept.
+    if(utilization <= util_max){
+      accepted = true;
+    }
+
+    // Debugging : Print the calculated utilization and the bound.
+    // printf("Utilization = %.3f\n", utilization);
+    // printf("Maximum Allowable Utilization = %.3f\n", util_max);
+    /* --- END~Solution --- */
+
+    // Store the results in the result structure.
+    result->accepted = accepted;
+    result->task_info.util = utilization;
+}
+
+void worst_case_simulation(TaskParams **params, unsigned int task_id,
+                           AcceptanceTestResult *result) {
+    TickType_t completion_time = 0;
+    bool accepted = false;
+
+    /*--------------------------------------------------------------------
+     * Subtask 2: Implement the Worst Case Simulation from the lecture
+     * The goal is to calculate the worst-case completion time of the 
+     * task under consideration (task_id) and check if it meets its deadline.
+     ---------------------------------------------------------------------*/
+
+    /* --- START~Solution --- */
+    double time = 0;  // Temporary variable for calculating completion time as a double.
+
+    // Sum up the contribution of each task of higher priority up to task under consideration to calculate the worst-case response time.
+    for (unsigned int i = 0; i <= task_id; ++i) {
+        // Calculate the Worst Case execution time according to formula
+        // Iterating over all higher priority tasks as well as current Task.
+        time += ceil( (double) params[task_id]->period / params[i]->period ) * params[i]->execution_time; // type cast is needed to avoid integer division which would result in floor instead of a ceil
+    }
+
+    // Round up the calculated time to the nearest integer using ceil, 
+    // since tasks execute at integer time points the task will have to wait until the next integer time to run.
+    completion_time = ceil(time);
+
+    // Check if the calculated completion time is within the task's deadline (period).
+    // If completion_time <= task's period, the task meets its deadline and is accepted.
+    accepted = (completion_time <= params[task_id]->deadline) ? true : false; // Compare the worst case execution time to the period
+
+    /* --- END~Solution --- */
+
+    result->accepted = accepted;
+    result->task_info.wcs_result = completion_time;
+}
+
+
+void time_demand_analysis(TaskParams **params, unsigned int task_id,
+                          AcceptanceTestResult *result) {
+    TickType_t t_last = 0, t_next = 0; 
+    bool accepted = false;
+
+    /*--------------------------------------------------------------------
+     * Subtask 3: Implement the Time Demand Analysis from the lecture
+     * The goal is to check if task `task_id` can meet its deadline.
+     ---------------------------------------------------------------------*/
+    
+    /* --- START~Solution --- */
+
+    // printf("\nTASK: %d\n", task_id);  // DEBUGGING
+
+    // Step 1: Calculate t0
+    for (unsigned int i = 0; i <= task_id; ++i) {
+        t_last += params[i]->execution_time;  // Sum up execution times of all tasks up to task under consideration
+    }
+    // printf("T0: %ld\n", t_last);  // DEBUGGING
+
+    // Step 2: Iterate to calculate the time demand until the system converges
+    while (true) {
+        // Calculate t_next (next demand time considering all tasks of higher priority up to task under consideration)
+        t_next = 0;  // Reset t_next at the start of each iteration
+
+        // Calculate t_next considering each task up to task_id
+        for (unsigned int j = 0; j <= task_id; ++j) {
+            t_next += ceil( (j == task_id) ? params[j]->execution_time : ceil((double)t_last / params[j]->period) * params[j]->execution_time );
+            // ceil((double)t_last / params[j]->period) : ceil is used to perform the jump in the staircase for each multiple of higher priority task period
+            // ceil is then applied to the entire value as t_next is of type TickType_t which does not accept floating point numbers, thus the value is ceiled to test worst case scenario
+        }
+        // printf("T_Next: %ld\n", t_next);  // DEBUGGING
+
+        // Check for convergence or exceeding the deadline
+        if (t_next > params[task_id]->deadline) {
+            accepted = false;  // If t_next exceeds deadline, task is not schedulable
+            break;
+        }
+
+        if (t_next == t_last) {
+            accepted = true;  // If t_next equals t_last, the system has converged and since the value did not trigger the previous if condition to check for exceeding the deadline, it converged to a value less than the deadline
+            break;
+        }
+
+        // Update t_last for the next iteration
+        t_last = t_next;
+    }
+
+    /* --- END~Solution --- */
+
+    // Store the results
+    result->accepted = accepted; 
+    result->task_info.tda_result = t_next;
+
+    
+}
+
+
+/* Precomputed Liu & Layland bound n * (2^(1/n) - 1) in Q16, rounded down.
+ * Larger task sets fall back to the integer root below. */
+static const q16_t liu_layland_bound_q16[] = {
+    65536, 54291, 51102, 49599, 48725, 48154, 47751, 47452,
+    47221, 47037, 46887, 46763, 46658, 46569, 46492, 46424,
+    46364, 46312, 46264, 46222, 46184, 46149, 46117, 46088,
+    46061, 46037, 46014, 45993, 45973, 45954, 45937, 45921};
+#define LIU_LAYLAND_TABLE_SIZE                                                 \
+  (sizeof(liu_layland_bound_q16) / sizeof(liu_layland_bound_q16[0]))
+
+static uint64_t div_ceil_u64(uint64_t x, uint64_t y) {
+  return x / y + (x % y != 0);
+}
+
+// Q16 product, rounded up
+static uint64_t q16_mul_up(uint64_t a, uint64_t b) {
+  return (a * b + Q16_ONE - 1) >> 16;
+}
+
+/* x^n in Q16, rounded up. Values are saturated at 4.0, which is enough
+ * since the result is only compared against numbers in [1, 2]. */
+static uint64_t q16_pow_up(uint64_t x, unsigned int n) {
+  const uint64_t saturation = 4 * Q16_ONE;
+  uint64_t result = Q16_ONE;
+  while (n > 0) {
+    if (n & 1) {
+      result = q16_mul_up(result, x);
+      if (result > saturation)
+        return saturation;
+    }
+    n >>= 1;
+    if (n > 0) {
+      x = q16_mul_up(x, x);
+      if (x > saturation)
+        x = saturation;
+    }
+  }
+  return result;
+}
+
+// Largest x in Q16 with x^n <= y for 1 <= y <= 2 (never overestimates)
+static q16_t q16_root_floor(q16_t y, unsigned int n) {
+  q16_t low = Q16_ONE, high = 2 * Q16_ONE;
+  while (low < high) {
+    q16_t mid = low + (high - low + 1) / 2;
+    if (q16_pow_up(mid, n) <= y)
+      low = mid;
+    else
+      high = mid - 1;
+  }
+  return low;
+}
+
+q16_t utilization_q16(TickType_t execution_time, TickType_t period) {
+  return (q16_t)div_ceil_u64((uint64_t)execution_time << 16, period);
+}
+
+/* Integer counterpart of utilization_bound(), rounded down. The common case
+ * deadline == period is a table lookup, all other cases need one integer
+ * n-th root (binary search over Q16, no pow()). */
+q16_t utilization_bound_q16(unsigned int n, TickType_t deadline,
+                            TickType_t period) {
+  uint64_t delta_down = ((uint64_t)deadline << 16) / period;
+
+  if (deadline == period && n <= LIU_LAYLAND_TABLE_SIZE) {
+    return liu_layland_bound_q16[n - 1];
+  }
+  if (2 * (uint64_t)deadline <= period) {
+    return (q16_t)delta_down;
+  }
+  if (deadline <= period) {
+    // n * ((2 * delta)^(1/n) - 1) + 1 - delta
+    q16_t x = q16_root_floor((q16_t)(2 * delta_down), n);
+    uint64_t delta_up = div_ceil_u64((uint64_t)deadline << 16, period);
+    return (q16_t)((uint64_t)n * (x - Q16_ONE) + Q16_ONE - delta_up);
+  }
+  // delta * n * (((delta + 1) / delta)^(1/n) - 1)
+  q16_t x = q16_root_floor(
+      (q16_t)((((uint64_t)deadline + period) << 16) / deadline), n);
+  return (q16_t)((delta_down * n * (x - Q16_ONE)) >> 16);
+}
+
+void utilization_bound_test_int(TaskParams **params, unsigned int task_id,
+                                AcceptanceTestResult *result) {
+  uint64_t utilization = 0;
+  for (unsigned int i = 0; i <= task_id; ++i) {
+    utilization +=
+        utilization_q16(params[i]->execution_time, params[i]->period);
+  }
+
+  result->accepted =
+      utilization <= utilization_bound_q16(task_id + 1,
+                                           params[task_id]->deadline,
+                                           params[task_id]->period);
+  // conversion is only needed for the display
+  result->task_info.util = (double)utilization / Q16_ONE;
+}
+
+// Factor (U + 1) of the hyperbolic bound in Q16, saturated at 4.0
+static uint64_t hyperbolic_factor(q16_t utilization) {
+  uint64_t factor = Q16_ONE + (uint64_t)utilization;
+  return factor < 4 * Q16_ONE ? factor : 4 * Q16_ONE;
+}
+
+void hyperbolic_bound_test_int(TaskParams **params, unsigned int task_id,
+                               AcceptanceTestResult *result) {
+  uint64_t utilization = 0, product = Q16_ONE;
+  for (unsigned int i = 0; i <= task_id; ++i) {
+    q16_t u = utilization_q16(params[i]->execution_time, params[i]->period);
+    utilization += u;
+    product = q16_mul_up(product, hyperbolic_factor(u));
+    if (product > 4 * Q16_ONE)
+      product = 4 * Q16_ONE;
+  }
+
+  result->accepted = params[task_id]->deadline >= params[task_id]->period &&
+                     product <= 2 * Q16_ONE;
+  // conversion is only needed for the display
+  result->task_info.util = (double)utilization / Q16_ONE;
+}
+
+void worst_case_simulation_int(TaskParams **params, unsigned int task_id,
+                               AcceptanceTestResult *result) {
+  TickType_t completion_time = 0;
+  for (unsigned int i = 0; i <= task_id; ++i) {
+    completion_time += div_ceil(params[task_id]->period, params[i]->period) *
+                       params[i]->execution_time;
+  }
+
+  result->accepted = completion_time <= params[task_id]->deadline;
+  result->task_info.wcs_result = completion_time;
+}
+
+void time_demand_analysis_int(TaskParams **params, unsigned int task_id,
+                              AcceptanceTestResult *result) {
+  TaskParams *task = params[task_id];
+  TickType_t t_last = 0, t_next;
+
+  for (unsigned int i = 0; i <= task_id; ++i) {
+    t_last += params[i]->execution_time;
+  }
+
+  result->accepted = false;
+  t_next = t_last;
+  while (t_next <= task->deadline) {
+    t_next = task->execution_time;
+    for (unsigned int j = 0; j < task_id; ++j) {
+      t_next += div_ceil(t_last, params[j]->period) * params[j]->execution_time;
+    }
+    if (t_next == t_last) {
+      result->accepted = true;
+      break;
+    }
+    t_last = t_next;
+  }
+  result->task_info.tda_result = t_next;
+}
+
+
+/* Number of harmonic chains the periods of params[0..task_id] are split
+ * into: a task extends the chain whose last period is the largest one that
+ * divides its own, or starts a new chain. Greedy, so it may find more
+ * chains than needed, which only lowers the bound. Chains are tracked for
+ * the first 64 tasks, each later task counts as a chain of its own. */
+static unsigned int harmonic_chains(TaskParams **params,
+                                    unsigned int task_id) {
+  uint64_t tails = 0; // last task of each chain
+  unsigned int chains = 0;
+  for (unsigned int i = 0; i <= task_id; ++i) {
+    int tail = -1;
+    for (unsigned int j = 0; j < i && j < 64; ++j) {
+      if ((tails >> j & 1) && params[i]->period % params[j]->period == 0 &&
+          (tail < 0 || params[j]->period > params[tail]->period))
+        tail = j;
+    }
+    if (tail >= 0)
+      tails &= ~(1ULL << tail);
+    else
+      chains++;
+    if (i < 64)
+      tails |= 1ULL << i;
+  }
+  return chains;
+}
+
+/* Determine if params[task_id] can be scheduled.
+ * - params: array of all task parameters (e.g., needed to perform TDA)
+ * - task_id: index such that params[task_id] is the task under consideration
+ * - results: output parameter yielding the acceptance test result
+ *
+ * Fused version of the tests above: the utilization, the hyperbolic product,
+ * the WCS completion time and the initial time demand t0 of the TDA are all
+ * accumulated in a single sweep over params[0..task_id]. Only the integer
+ * kernels are used, so no floating point rounding affects the decision. The
+ * tests are then evaluated from cheapest to most expensive and the first
+ * conclusive one decides ('stage'). The TDA fixed point is only iterated if
+ * no sufficient test accepts the task, so 'tda_result' stays 0 otherwise,
+ * see acceptance_test_complete_info.
+ * The TDA assumes that all tasks are released together. If some tasks have a
+ * release offset, this critical instant may never occur, so a rejection by
+ * the TDA is double-checked by simulating the actual schedule over the
+ * hyperperiod ('sim_result' holds the worst observed response time). */
+void acceptance_test(TaskParams **params, unsigned int task_id,
+                     AcceptanceTestResult *result) {
+    TaskParams *task = params[task_id];
+    uint64_t utilization = 0;
+    TickType_t wcs_time = 0;
+    TickType_t t_last = 0, t_next = 0;
+    uint64_t hyperbolic = Q16_ONE;
+    bool offsets = false;
+
+    // Single sweep: the partial sums of all tests share one loop
+    for (unsigned int i = 0; i <= task_id; ++i) {
+        q16_t u = utilization_q16(params[i]->execution_time, params[i]->period);
+        utilization += u;
+        hyperbolic = q16_mul_up(hyperbolic, hyperbolic_factor(u));
+        if (hyperbolic > 4 * Q16_ONE)
+            hyperbolic = 4 * Q16_ONE;
+        wcs_time += div_ceil(task->period, params[i]->period) * params[i]->execution_time;
+        t_last += params[i]->execution_time;
+        offsets |= params[i]->release_time != 0;
+    }
+
+    result->accepted = false;
+    result->task_info.util = (double)utilization / Q16_ONE;
+    result->task_info.wcs_result = wcs_time;
+    result->task_info.tda_result = 0;
+    result->task_info.sim_result = 0;
+
+    // Step 1: Utilization Bound Test (Sufficient Condition)
+    result->stage = STAGE_UTILIZATION_BOUND;
+    if (utilization <= utilization_bound_q16(task_id + 1, task->deadline, task->period)) {
+        result->accepted = true;
+        return;
+    }
+
+    // Step 2: Hyperbolic Bound (Sufficient Condition, deadline >= period)
+    result->stage = STAGE_HYPERBOLIC_BOUND;
+    if (task->deadline >= task->period && hyperbolic <= 2 * Q16_ONE) {
+        result->accepted = true;
+        return;
+    }
+
+    // Step 3: Harmonic Chains (Sufficient Condition, deadline >= period).
+    // Kuo & Mok: tasks in K harmonic chains meet the Liu & Layland bound of
+    // K instead of n tasks, so a single chain can use the whole processor.
+    result->stage = STAGE_HARMONIC_CHAIN;
+    if (task->deadline >= task->period &&
+        utilization <= utilization_bound_q16(harmonic_chains(params, task_id),
+                                             1, 1)) {
+        result->accepted = true;
+        return;
+    }
+
+    // Step 4: Worst-Case Simulation (Sufficient Condition)
+    result->stage = STAGE_WORST_CASE_SIMULATION;
+    if (wcs_time <= task->deadline) {
+        result->accepted = true;
+        return;
+    }
+
+    // Step 5: Time Demand Analysis (Necessary & Sufficient Condition).
+    // The demand never drops below t0, so t0 > deadline already rejects.
+    result->stage = STAGE_TIME_DEMAND_ANALYSIS;
+    t_next = t_last;
+    while (t_next <= task->deadline) {
+        t_next = task->execution_time;
+        for (unsigned int j = 0; j < task_id; ++j) {
+            t_next += div_ceil(t_last, params[j]->period) * params[j]->execution_time;
+        }
+        if (t_next == t_last) {
+            result->accepted = true;
+            break;
+        }
+        t_last = t_next;
+    }
+    result->task_info.tda_result = t_next;
+
+    // Step 6: Hyperperiod Simulation (Exact, only needed with release offsets)
+    if (result->accepted || !offsets)
+        return;
+    SimulationResult *simulation =
+        pvPortMalloc((task_id + 1) * sizeof(SimulationResult));
+    if (simulation == NULL) {
+        printf("ERROR: Memory allocation for acceptance_test failed\n");
+        return;
+    }
+    if (fixed_priority_simulation(params, task_id + 1,
+                                  SIMULATION_MAX_HORIZON, simulation)) {
+        result->stage = STAGE_SIMULATION;
+        result->accepted = simulation[task_id].accepted;
+        result->task_info.sim_result = simulation[task_id].response_time;
+    }
+    vPortFree(simulation);
+}
+
+void acceptance_test_complete_info(TaskParams **params, unsigned int task_id,
+                                   TaskInfo *task_info) {
+  AcceptanceTestResult result = default_result;
+  if (task_info->wcs_result == 0) {
+    worst_case_simulation_int(params, task_id, &result);
+    task_info->wcs_result = result.task_info.wcs_result;
+  }
+  if (task_info->tda_result == 0) {
+    time_demand_analysis_int(params, task_id, &result);
+    task_info->tda_result = result.task_info.tda_result;
+  }
+}
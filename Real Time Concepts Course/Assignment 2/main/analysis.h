@@ -0,0 +1,77 @@
+#ifndef TDA_ANALYSIS_H
+#define TDA_ANALYSIS_H
+
+#include "display.h"
+#include "tasks.h"
+
+/* Stages of acceptance_test, from cheapest to most expensive. The first
+ * conclusive stage decides and is reported in AcceptanceTestResult.stage. */
+typedef enum {
+  STAGE_UTILIZATION_BOUND,
+  STAGE_HYPERBOLIC_BOUND,
+  STAGE_HARMONIC_CHAIN,
+  STAGE_WORST_CASE_SIMULATION,
+  STAGE_TIME_DEMAND_ANALYSIS,
+  STAGE_SIMULATION,
+  NUMBER_OF_STAGES
+} AcceptanceStage;
+extern const char *const acceptance_stage_names[NUMBER_OF_STAGES];
+
+typedef struct {
+  bool accepted;
+  TaskInfo task_info;
+  AcceptanceStage stage;
+} AcceptanceTestResult;
+extern AcceptanceTestResult default_result;
+
+/* Unsigned Q16.16 fixed point number, i.e., Q16_ONE corresponds to 1.0.
+ * Used for utilizations and utilization bounds of the integer tests. */
+typedef uint32_t q16_t;
+#define Q16_ONE (1UL << 16)
+
+TickType_t div_ceil(TickType_t x, TickType_t y);
+
+/* Schedulability tests for RMS. All of them check whether params[task_id]
+ * is schedulable together with the higher priority tasks params[0..task_id-1]
+ * and store the decision and the computed value in 'result'. */
+void utilization_bound_test(TaskParams **params, unsigned int task_id,
+                            AcceptanceTestResult *result);
+void worst_case_simulation(TaskParams **params, unsigned int task_id,
+                           AcceptanceTestResult *result);
+void time_demand_analysis(TaskParams **params, unsigned int task_id,
+                          AcceptanceTestResult *result);
+
+/* Integer versions of the tests above, using neither floating point nor
+ * pow() / ceil(). The utilization is rounded up and the bound is rounded
+ * down, so the utilization bound test never accepts a task that the exact
+ * real-valued test would reject. */
+q16_t utilization_q16(TickType_t execution_time, TickType_t period);
+q16_t utilization_bound_q16(unsigned int n, TickType_t deadline,
+                            TickType_t period);
+void utilization_bound_test_int(TaskParams **params, unsigned int task_id,
+                                AcceptanceTestResult *result);
+/* Hyperbolic bound of Bini & Buttazzo: prod(U_i + 1) <= 2. Dominates the
+ * Liu & Layland bound, but needs deadline >= period. The product is rounded
+ * up, so the test stays sufficient. */
+void hyperbolic_bound_test_int(TaskParams **params, unsigned int task_id,
+                               AcceptanceTestResult *result);
+void worst_case_simulation_int(TaskParams **params, unsigned int task_id,
+                               AcceptanceTestResult *result);
+void time_demand_analysis_int(TaskParams **params, unsigned int task_id,
+                              AcceptanceTestResult *result);
+
+/* Determine if params[task_id] can be scheduled.
+ * - params: array of all task parameters (e.g., needed to perform TDA)
+ * - task_id: index such that params[task_id] is the task under consideration
+ * - results: output parameter yielding the acceptance test result */
+void acceptance_test(TaskParams **params, unsigned int task_id,
+                     AcceptanceTestResult *result);
+
+/* Fill in the WCS completion time and the TDA fixed point of 'task_info'
+ * if the stage that decided, or the O(1) path of the admission, skipped
+ * them. Only needed for the display, so it runs after the admission. Same
+ * arguments as acceptance_test. */
+void acceptance_test_complete_info(TaskParams **params, unsigned int task_id,
+                                   TaskInfo *task_info);
+
+#endif
@@ -0,0 +1,60 @@
+#include "benchmark.h"
+#include "analysis.h"
+#include "esp_cpu.h"
+
+typedef void (*AnalysisTest)(TaskParams **params, unsigned int task_id,
+                             AcceptanceTestResult *result);
+
+typedef struct {
+  const char *name;
+  AnalysisTest double_test;
+  AnalysisTest int_test;
+} BenchmarkCase;
+
+static const BenchmarkCase benchmark_cases[] = {
+    {"UB", utilization_bound_test, utilization_bound_test_int},
+    {"WCS", worst_case_simulation, worst_case_simulation_int},
+    {"TDA", time_demand_analysis, time_demand_analysis_int},
+};
+
+// Average cycles of a single call of 'test'
+static uint32_t benchmark_test(AnalysisTest test, TaskParams **params,
+                               unsigned int number_of_tasks,
+                               unsigned int rounds,
+                               AcceptanceTestResult *results) {
+  uint32_t start = esp_cpu_get_cycle_count();
+  for (unsigned int r = 0; r < rounds; r++) {
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      test(params, i, &results[i]);
+    }
+  }
+  uint32_t cycles = esp_cpu_get_cycle_count() - start;
+  return cycles / (rounds * number_of_tasks);
+}
+
+void analysis_benchmark(TaskParams **params, unsigned int number_of_tasks,
+                        unsigned int rounds) {
+  AcceptanceTestResult double_results[number_of_tasks];
+  AcceptanceTestResult int_results[number_of_tasks];
+
+  if (number_of_tasks == 0 || rounds == 0)
+    return;
+
+  printf("BENCHMARK: %u tasks, %u rounds\n", number_of_tasks, rounds);
+  for (unsigned int c = 0;
+       c < sizeof(benchmark_cases) / sizeof(benchmark_cases[0]); c++) {
+    const BenchmarkCase *bench = &benchmark_cases[c];
+    uint32_t double_cycles = benchmark_test(
+        bench->double_test, params, number_of_tasks, rounds, double_results);
+    uint32_t int_cycles = benchmark_test(bench->int_test, params,
+                                         number_of_tasks, rounds, int_results);
+
+    unsigned int differing = 0;
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      differing += double_results[i].accepted != int_results[i].accepted;
+    }
+    printf("BENCHMARK: %-4s double %6" PRIu32 " cycles, int %6" PRIu32
+           " cycles, %u differing decisions\n",
+           bench->name, double_cycles, int_cycles, differing);
+  }
+}
@@ -0,0 +1,13 @@
+#ifndef TDA_BENCHMARK_H
+#define TDA_BENCHMARK_H
+
+#include "tasks.h"
+
+/* Microbenchmark of the floating point schedulability tests against their
+ * integer counterparts. Each test is run 'rounds' times for every task of
+ * params[0..number_of_tasks-1] and the average number of CPU cycles per call
+ * is printed, together with the number of differing decisions. */
+void analysis_benchmark(TaskParams **params, unsigned int number_of_tasks,
+                        unsigned int rounds);
+
+#endif
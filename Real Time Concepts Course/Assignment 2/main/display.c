@@ -1,6 +1,18 @@
 #include "display.h"
 
 ssd1306_handle_t ssd1306_dev = NULL;
+Framebuffer framebuffer;
+
+typedef enum { PAGE_TASK_INFO, PAGE_SENSITIVITY } DisplayPage;
+
+typedef struct {
+  DisplayPage page;
+  TaskParams params;
+  TaskInfo task_info;
+} DisplaySnapshot;
+
+static void render_page(const void *snapshot);
+
 void ssd1306_setup() {
   i2c_config_t conf;
   conf.mode = I2C_MODE_MASTER;
@@ -16,45 +28,108 @@ void ssd1306_setup() {
 
   // deprecated, you can get bonus points for updating it ;-)
   ssd1306_dev = ssd1306_create(I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
-  ssd1306_refresh_gram(ssd1306_dev);
-  ssd1306_clear_screen(ssd1306_dev, 0x00);
+  // only changed page segments are sent from here on, see framebuffer.h
+  framebuffer_init(&framebuffer, I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
+  // from here on, only the display server talks to the display
+  display_server_start(render_page, sizeof(DisplaySnapshot),
+                       DISPLAY_SERVER_PRIORITY,
+                       pdMS_TO_TICKS(1000UL / DISPLAY_MAX_FRAME_RATE));
 }
 
-void ssd1306_print_task_info(TaskParams *params, TaskInfo *task_info) {
-  char val[20];
-  ssd1306_clear_screen(ssd1306_dev, 0x00);
+static void render_task_info(const TaskParams *params,
+                             const TaskInfo *task_info) {
+  char val[24]; // fits any unsigned long
+  framebuffer_clear(&framebuffer);
 
   // print task name
-  snprintf(val, 20, "Task %d: (%lu,%lu)", params->id, params->period,
-           params->execution_time);
-  ssd1306_draw_string(ssd1306_dev, 10, 0, (const uint8_t *)val, 16, 1);
+  snprintf(val, sizeof(val), "Task %d: (%lu,%lu)", params->id,
+           params->period, params->execution_time);
+  framebuffer_draw_string(&framebuffer, 10, 0, val, 16, 1);
 
   // print cpu utilization
-  ssd1306_draw_string(ssd1306_dev, 10, 16, (const uint8_t *)"Util:", 16, 1);
+  framebuffer_draw_string(&framebuffer, 10, 16, "Util:", 16, 1);
   if (task_info->util > 0) {
-    snprintf(val, 16, "%.03f", task_info->util);
-    ssd1306_draw_string(ssd1306_dev, 70, 16, (const uint8_t *)val, 16, 1);
+    snprintf(val, sizeof(val), "%.03f", task_info->util);
+    framebuffer_draw_string(&framebuffer, 70, 16, val, 16, 1);
   } else {
-    ssd1306_draw_string(ssd1306_dev, 70, 16, (const uint8_t *)"-", 16, 1);
+    framebuffer_draw_string(&framebuffer, 70, 16, "-", 16, 1);
   }
 
   // print completion time test
-  ssd1306_draw_string(ssd1306_dev, 10, 32, (const uint8_t *)"WCS:", 16, 1);
+  framebuffer_draw_string(&framebuffer, 10, 32, "WCS:", 16, 1);
   if (task_info->wcs_result > 0) {
-    snprintf(val, 16, "%lu", task_info->wcs_result);
-    ssd1306_draw_string(ssd1306_dev, 70, 32, (const uint8_t *)val, 16, 1);
+    snprintf(val, sizeof(val), "%lu", task_info->wcs_result);
+    framebuffer_draw_string(&framebuffer, 70, 32, val, 16, 1);
   } else {
-    ssd1306_draw_string(ssd1306_dev, 70, 32, (const uint8_t *)"-", 16, 1);
+    framebuffer_draw_string(&framebuffer, 70, 32, "-", 16, 1);
   }
 
   // print completion time test
-  ssd1306_draw_string(ssd1306_dev, 10, 48, (const uint8_t *)"TDA:", 16, 1);
+  framebuffer_draw_string(&framebuffer, 10, 48, "TDA:", 16, 1);
   if (task_info->tda_result > 0) {
-    snprintf(val, 16, "%lu", task_info->tda_result);
-    ssd1306_draw_string(ssd1306_dev, 70, 48, (const uint8_t *)val, 16, 1);
+    snprintf(val, sizeof(val), "%lu", task_info->tda_result);
+    framebuffer_draw_string(&framebuffer, 70, 48, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 48, "-", 16, 1);
+  }
+
+  display_server_flush(&framebuffer);
+}
+
+static void render_sensitivity(const TaskParams *params,
+                               const TaskInfo *task_info) {
+  char val[24]; // fits any unsigned long
+  framebuffer_clear(&framebuffer);
+
+  // print task name
+  snprintf(val, sizeof(val), "Task %d: (%lu,%lu)", params->id,
+           params->period, params->execution_time);
+  framebuffer_draw_string(&framebuffer, 10, 0, val, 16, 1);
+
+  // print largest schedulable execution time
+  framebuffer_draw_string(&framebuffer, 10, 16, "Cmax:", 16, 1);
+  if (task_info->max_execution_time > 0) {
+    snprintf(val, sizeof(val), "%lu", task_info->max_execution_time);
+    framebuffer_draw_string(&framebuffer, 70, 16, val, 16, 1);
   } else {
-    ssd1306_draw_string(ssd1306_dev, 70, 48, (const uint8_t *)"-", 16, 1);
+    framebuffer_draw_string(&framebuffer, 70, 16, "-", 16, 1);
   }
 
-  ssd1306_refresh_gram(ssd1306_dev);
+  // print smallest schedulable period
+  framebuffer_draw_string(&framebuffer, 10, 32, "Tmin:", 16, 1);
+  if (task_info->min_period > 0) {
+    snprintf(val, sizeof(val), "%lu", task_info->min_period);
+    framebuffer_draw_string(&framebuffer, 70, 32, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 32, "-", 16, 1);
+  }
+
+  // print breakdown utilization of the whole task set
+  framebuffer_draw_string(&framebuffer, 10, 48, "Ubd:", 16, 1);
+  if (task_info->breakdown_util > 0) {
+    snprintf(val, sizeof(val), "%.03f", task_info->breakdown_util);
+    framebuffer_draw_string(&framebuffer, 70, 48, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 48, "-", 16, 1);
+  }
+
+  display_server_flush(&framebuffer);
+}
+
+static void render_page(const void *snapshot) {
+  const DisplaySnapshot *page = snapshot;
+  if (page->page == PAGE_TASK_INFO)
+    render_task_info(&page->params, &page->task_info);
+  else
+    render_sensitivity(&page->params, &page->task_info);
+}
+
+void ssd1306_print_task_info(TaskParams *params, TaskInfo *task_info) {
+  DisplaySnapshot snapshot = {PAGE_TASK_INFO, *params, *task_info};
+  display_server_post(&snapshot);
+}
+
+void ssd1306_print_sensitivity(TaskParams *params, TaskInfo *task_info) {
+  DisplaySnapshot snapshot = {PAGE_SENSITIVITY, *params, *task_info};
+  display_server_post(&snapshot);
 }
@@ -3,6 +3,8 @@
 
 /* No need to change anything here... */
 
+#include "display_server.h"
+#include "framebuffer.h"
 #include "freertos/FreeRTOS.h"
 #include "sdkconfig.h"
 #include "ssd1306.h"
@@ -14,15 +16,22 @@
 #define I2C_MASTER_NUM I2C_NUM_1
 #define I2C_MASTER_FREQ_HZ 100000
 
+#define DISPLAY_MAX_FRAME_RATE 10
+
 typedef struct {
   double util;
   TickType_t wcs_result;
   TickType_t tda_result;
+  TickType_t sim_result;
+  TickType_t max_execution_time;
+  TickType_t min_period;
+  double breakdown_util;
 } TaskInfo;
 
-static const TaskInfo default_task_info = {0, 0, 0};
+static const TaskInfo default_task_info = {0, 0, 0, 0, 0, 0, 0};
 
 void ssd1306_setup();
 void ssd1306_print_task_info(TaskParams *params, TaskInfo *task_info);
+void ssd1306_print_sensitivity(TaskParams *params, TaskInfo *task_info);
 
 #endif
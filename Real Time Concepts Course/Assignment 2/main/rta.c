@@ -0,0 +1,137 @@
+#include "rta.h"
+
+/* The classic TDA restarts every task from t0 = sum(C) and recomputes every
+ * ceil(t/T_j) term in each iteration. Here, all tasks are analysed in one
+ * pass instead:
+ *  - Warm start: R_i >= R_(i-1) + C_i, so task i starts at the last
+ *    iterate of task i-1 plus its own execution time.
+ *  - The number of released jobs n_j = ceil(t/T_j) of each higher priority
+ *    task only changes when t passes the period boundary n_j * T_j. These
+ *    boundaries are kept in a min-heap, so an iteration only touches the
+ *    tasks whose boundary was actually crossed.
+ * Since t never decreases, the heap and the interference sum carry over
+ * from one task to the next. */
+
+typedef struct {
+  TaskParams **params;
+  TickType_t *jobs;      // n_j = ceil(t / T_j) for every task in the heap
+  TickType_t *boundary;  // n_j * T_j
+  unsigned int *heap;    // task indices, ordered by boundary
+  unsigned int size;
+} InterferenceHeap;
+
+static void heap_swap(InterferenceHeap *h, unsigned int a, unsigned int b) {
+  unsigned int tmp = h->heap[a];
+  h->heap[a] = h->heap[b];
+  h->heap[b] = tmp;
+}
+
+static void heap_sift_up(InterferenceHeap *h, unsigned int pos) {
+  while (pos > 0) {
+    unsigned int parent = (pos - 1) / 2;
+    if (h->boundary[h->heap[parent]] <= h->boundary[h->heap[pos]])
+      break;
+    heap_swap(h, parent, pos);
+    pos = parent;
+  }
+}
+
+static void heap_sift_down(InterferenceHeap *h, unsigned int pos) {
+  while (true) {
+    unsigned int smallest = pos, left = 2 * pos + 1, right = 2 * pos + 2;
+    if (left < h->size &&
+        h->boundary[h->heap[left]] < h->boundary[h->heap[smallest]])
+      smallest = left;
+    if (right < h->size &&
+        h->boundary[h->heap[right]] < h->boundary[h->heap[smallest]])
+      smallest = right;
+    if (smallest == pos)
+      break;
+    heap_swap(h, smallest, pos);
+    pos = smallest;
+  }
+}
+
+// Add task j as an interferer at time t, returns its interference
+static TickType_t heap_push(InterferenceHeap *h, unsigned int j,
+                            TickType_t t) {
+  TickType_t period = h->params[j]->period;
+  h->jobs[j] = t / period + (t % period != 0);
+  h->boundary[j] = h->jobs[j] * period;
+  h->heap[h->size] = j;
+  heap_sift_up(h, h->size++);
+  return h->jobs[j] * h->params[j]->execution_time;
+}
+
+// Move all boundaries that were passed by t, returns the added interference
+static TickType_t heap_advance(InterferenceHeap *h, TickType_t t) {
+  TickType_t added = 0;
+  while (h->size > 0 && h->boundary[h->heap[0]] < t) {
+    unsigned int j = h->heap[0];
+    TickType_t period = h->params[j]->period;
+    TickType_t jobs = t / period + (t % period != 0);
+    added += (jobs - h->jobs[j]) * h->params[j]->execution_time;
+    h->jobs[j] = jobs;
+    h->boundary[j] = jobs * period;
+    heap_sift_down(h, 0);
+  }
+  return added;
+}
+
+unsigned int response_time_analysis(TaskParams **params,
+                                    unsigned int number_of_tasks,
+                                    RTAResult *results) {
+  InterferenceHeap h = {.params = params, .size = 0};
+  unsigned int total_iterations = 0;
+
+  if (number_of_tasks == 0)
+    return 0;
+
+  h.jobs = pvPortMalloc(number_of_tasks * sizeof(TickType_t));
+  h.boundary = pvPortMalloc(number_of_tasks * sizeof(TickType_t));
+  h.heap = pvPortMalloc(number_of_tasks * sizeof(unsigned int));
+  if (h.jobs == NULL || h.boundary == NULL || h.heap == NULL) {
+    printf("ERROR: Memory allocation for response_time_analysis failed\n");
+    vPortFree(h.jobs);
+    vPortFree(h.boundary);
+    vPortFree(h.heap);
+    return 0;
+  }
+
+  TickType_t t = 0, interference = 0;
+  for (unsigned int i = 0; i < number_of_tasks; ++i) {
+    TaskParams *task = params[i];
+    unsigned int iterations = 0;
+
+    // the previous task becomes an interferer of all following tasks
+    if (i > 0)
+      interference += heap_push(&h, i - 1, t);
+
+    // warm start from the last iterate of the previous task
+    t += task->execution_time;
+    while (true) {
+      interference += heap_advance(&h, t);
+      TickType_t t_next = task->execution_time + interference;
+      iterations++;
+      if (t_next > task->deadline) {
+        results[i].accepted = false;
+        t = t_next;
+        break;
+      }
+      if (t_next == t) {
+        results[i].accepted = true;
+        break;
+      }
+      t = t_next;
+    }
+
+    results[i].response_time = t;
+    results[i].iterations = iterations;
+    total_iterations += iterations;
+  }
+
+  vPortFree(h.jobs);
+  vPortFree(h.boundary);
+  vPortFree(h.heap);
+  return total_iterations;
+}
@@ -0,0 +1,23 @@
+#ifndef TDA_RTA_H
+#define TDA_RTA_H
+
+#include "tasks.h"
+
+typedef struct {
+  bool accepted;
+  TickType_t response_time;
+  unsigned int iterations;
+} RTAResult;
+
+/* Incremental response time analysis of params[0..number_of_tasks-1].
+ * The tasks have to be ordered by decreasing priority (index 0 first), i.e.,
+ * the same order that is used by the acceptance test.
+ * - results: output array of size number_of_tasks. results[i].response_time
+ *   holds the converged response time of task i (or the first value that
+ *   exceeded its deadline if it is not schedulable).
+ * Returns the total number of fixed point iterations over all tasks. */
+unsigned int response_time_analysis(TaskParams **params,
+                                    unsigned int number_of_tasks,
+                                    RTAResult *results);
+
+#endif
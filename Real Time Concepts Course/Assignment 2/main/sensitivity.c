@@ -0,0 +1,194 @@
+#include "sensitivity.h"
+#include "analysis.h"
+
+typedef struct {
+  TaskParams *copy;     // modified copy of the task set
+  TaskParams **view;    // pointers to 'copy' in priority order
+  TickType_t *known;    // response times of the last schedulable probe
+  TickType_t *probe;    // response times of the current probe
+  unsigned int number_of_tasks;
+  unsigned int iterations;
+} Search;
+
+/* TDA of view[task_id], starting from a lower bound of its response time.
+ * Below the response time R, the time demand W(t) is always larger than t,
+ * so the iteration climbs monotonically to R. */
+static bool tda_from(Search *s, unsigned int task_id, TickType_t start) {
+  TaskParams *task = s->view[task_id];
+  TickType_t t = 0, t_next;
+
+  for (unsigned int j = 0; j <= task_id; ++j) {
+    t += s->view[j]->execution_time;
+  }
+  if (start > t)
+    t = start;
+
+  while (t <= task->deadline) {
+    t_next = task->execution_time;
+    for (unsigned int j = 0; j < task_id; ++j) {
+      t_next += div_ceil(t, s->view[j]->period) * s->view[j]->execution_time;
+    }
+    s->iterations++;
+    if (t_next == t) {
+      s->probe[task_id] = t;
+      return true;
+    }
+    t = t_next;
+  }
+  s->probe[task_id] = t;
+  return false;
+}
+
+// Check tasks first..n-1, which are the only ones affected by a change
+static bool probe(Search *s, unsigned int first) {
+  for (unsigned int j = first; j < s->number_of_tasks; ++j) {
+    if (!tda_from(s, j, s->known[j]))
+      return false;
+  }
+  for (unsigned int j = first; j < s->number_of_tasks; ++j) {
+    s->known[j] = s->probe[j];
+  }
+  return true;
+}
+
+static TickType_t max_execution_time(Search *s, unsigned int i,
+                                     TickType_t *baseline) {
+  TaskParams *task = &s->copy[i];
+  TickType_t original = task->execution_time;
+  TickType_t low = original;
+  TickType_t high = task->deadline < task->period ? task->deadline
+                                                  : task->period;
+
+  for (unsigned int j = 0; j < s->number_of_tasks; ++j) {
+    s->known[j] = baseline[j];
+  }
+  // largest schedulable execution time in [low, high]
+  while (low < high) {
+    task->execution_time = low + (high - low + 1) / 2;
+    if (probe(s, i))
+      low = task->execution_time;
+    else
+      high = task->execution_time - 1;
+  }
+  task->execution_time = original;
+  return low;
+}
+
+static TickType_t min_period(Search *s, unsigned int i, TickType_t *baseline) {
+  TaskParams *task = &s->copy[i];
+  TickType_t original_period = task->period;
+  TickType_t original_deadline = task->deadline;
+  TickType_t low = task->execution_time > 0 ? task->execution_time : 1;
+  TickType_t high = original_period;
+
+  for (unsigned int j = 0; j < s->number_of_tasks; ++j) {
+    s->known[j] = baseline[j];
+  }
+  // smallest schedulable period in [low, high]
+  while (low < high) {
+    task->period = low + (high - low) / 2;
+    task->deadline =
+        original_deadline < task->period ? original_deadline : task->period;
+    if (probe(s, i))
+      high = task->period;
+    else
+      low = task->period + 1;
+  }
+  task->period = original_period;
+  task->deadline = original_deadline;
+  return high;
+}
+
+// WCETs scaled by the Q16 factor 'scale', rounded up
+static void scale_execution_times(Search *s, TaskParams **params,
+                                  uint64_t scale) {
+  for (unsigned int j = 0; j < s->number_of_tasks; ++j) {
+    uint64_t scaled = (uint64_t)params[j]->execution_time * scale;
+    s->copy[j].execution_time = scaled / Q16_ONE + (scaled % Q16_ONE != 0);
+  }
+}
+
+static double breakdown_utilization(Search *s, TaskParams **params,
+                                    TickType_t *baseline) {
+  uint64_t low = Q16_ONE, high = UINT32_MAX;
+  double utilization = 0;
+
+  // beyond this factor, some task exceeds its own deadline
+  for (unsigned int j = 0; j < s->number_of_tasks; ++j) {
+    uint64_t limit = ((uint64_t)params[j]->deadline + 1) * Q16_ONE /
+                     (params[j]->execution_time ? params[j]->execution_time
+                                                : 1);
+    if (limit < high)
+      high = limit;
+    s->known[j] = baseline[j];
+  }
+  // largest schedulable scaling factor in [low, high]
+  while (low < high) {
+    uint64_t mid = low + (high - low + 1) / 2;
+    scale_execution_times(s, params, mid);
+    if (probe(s, 0))
+      low = mid;
+    else
+      high = mid - 1;
+  }
+
+  scale_execution_times(s, params, low);
+  for (unsigned int j = 0; j < s->number_of_tasks; ++j) {
+    utilization += (double)s->copy[j].execution_time / s->copy[j].period;
+    s->copy[j].execution_time = params[j]->execution_time;
+  }
+  return utilization;
+}
+
+unsigned int sensitivity_analysis(TaskParams **params,
+                                  unsigned int number_of_tasks,
+                                  TaskInfo **task_info) {
+  Search s = {.number_of_tasks = number_of_tasks, .iterations = 0};
+
+  if (number_of_tasks == 0)
+    return 0;
+
+  s.copy = pvPortMalloc(number_of_tasks * sizeof(TaskParams));
+  s.view = pvPortMalloc(number_of_tasks * sizeof(TaskParams *));
+  s.known = pvPortMalloc(number_of_tasks * sizeof(TickType_t));
+  s.probe = pvPortMalloc(number_of_tasks * sizeof(TickType_t));
+  TickType_t *baseline = pvPortMalloc(number_of_tasks * sizeof(TickType_t));
+  if (s.copy == NULL || s.view == NULL || s.known == NULL ||
+      s.probe == NULL || baseline == NULL) {
+    printf("ERROR: Memory allocation for sensitivity_analysis failed\n");
+    vPortFree(s.copy);
+    vPortFree(s.view);
+    vPortFree(s.known);
+    vPortFree(s.probe);
+    vPortFree(baseline);
+    return 0;
+  }
+
+  for (unsigned int j = 0; j < number_of_tasks; ++j) {
+    s.copy[j] = *params[j];
+    s.view[j] = &s.copy[j];
+    s.known[j] = 0;
+  }
+
+  // response times of the unmodified set are the lower bounds of all probes
+  if (probe(&s, 0)) {
+    for (unsigned int j = 0; j < number_of_tasks; ++j) {
+      baseline[j] = s.known[j];
+    }
+    double breakdown = breakdown_utilization(&s, params, baseline);
+    for (unsigned int i = 0; i < number_of_tasks; ++i) {
+      task_info[i]->max_execution_time = max_execution_time(&s, i, baseline);
+      task_info[i]->min_period = min_period(&s, i, baseline);
+      task_info[i]->breakdown_util = breakdown;
+    }
+  } else {
+    s.iterations = 0;
+  }
+
+  vPortFree(s.copy);
+  vPortFree(s.view);
+  vPortFree(s.known);
+  vPortFree(s.probe);
+  vPortFree(baseline);
+  return s.iterations;
+}
@@ -0,0 +1,25 @@
+#ifndef TDA_SENSITIVITY_H
+#define TDA_SENSITIVITY_H
+
+#include "display.h"
+#include "tasks.h"
+
+/* Sensitivity analysis of a schedulable task set under RMS.
+ * params[0..number_of_tasks-1] have to be ordered by decreasing priority.
+ * For every task i, task_info[i] receives:
+ *  - max_execution_time: largest WCET of task i that keeps the set
+ *    schedulable (all other parameters unchanged)
+ *  - min_period: smallest period of task i (with deadline min(D_i, T_i))
+ *    that keeps the set schedulable at the current priority order
+ *  - breakdown_util: utilization of the set once all WCETs are scaled up by
+ *    the largest common factor that keeps it schedulable
+ * All values are found by binary search over the integer TDA. Response
+ * times only grow with the load, so each probe starts its fixed point
+ * iteration from the response times of the last schedulable probe.
+ * Returns the total number of TDA iterations, or 0 if the task set is not
+ * schedulable (the fields are then left at 0). */
+unsigned int sensitivity_analysis(TaskParams **params,
+                                  unsigned int number_of_tasks,
+                                  TaskInfo **task_info);
+
+#endif
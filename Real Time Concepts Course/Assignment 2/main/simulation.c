@@ -0,0 +1,200 @@
+#include "simulation.h"
+
+typedef struct {
+  uint64_t next_release;
+  uint64_t released;  // number of released jobs
+  uint64_t completed; // number of completed jobs
+  TickType_t remaining; // remaining execution time of the oldest job
+} SimulatedTask;
+
+/* Min-heap of task indices, either ordered by the next release time
+ * (release queue) or by the index itself, i.e., the priority (ready queue). */
+typedef struct {
+  SimulatedTask *tasks;
+  unsigned int *heap;
+  unsigned int size;
+  bool by_release;
+} EventHeap;
+
+static bool heap_less(EventHeap *h, unsigned int a, unsigned int b) {
+  if (h->by_release &&
+      h->tasks[a].next_release != h->tasks[b].next_release)
+    return h->tasks[a].next_release < h->tasks[b].next_release;
+  return a < b;
+}
+
+static void heap_swap(EventHeap *h, unsigned int a, unsigned int b) {
+  unsigned int tmp = h->heap[a];
+  h->heap[a] = h->heap[b];
+  h->heap[b] = tmp;
+}
+
+static void heap_sift_down(EventHeap *h, unsigned int pos) {
+  while (true) {
+    unsigned int smallest = pos, left = 2 * pos + 1, right = 2 * pos + 2;
+    if (left < h->size && heap_less(h, h->heap[left], h->heap[smallest]))
+      smallest = left;
+    if (right < h->size && heap_less(h, h->heap[right], h->heap[smallest]))
+      smallest = right;
+    if (smallest == pos)
+      break;
+    heap_swap(h, smallest, pos);
+    pos = smallest;
+  }
+}
+
+static void heap_push(EventHeap *h, unsigned int j) {
+  unsigned int pos = h->size++;
+  h->heap[pos] = j;
+  while (pos > 0) {
+    unsigned int parent = (pos - 1) / 2;
+    if (!heap_less(h, h->heap[pos], h->heap[parent]))
+      break;
+    heap_swap(h, parent, pos);
+    pos = parent;
+  }
+}
+
+static void heap_pop(EventHeap *h) {
+  h->heap[0] = h->heap[--h->size];
+  heap_sift_down(h, 0);
+}
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+  while (b != 0) {
+    uint64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+/* Number of tasks (in priority order) whose combined utilization is at most
+ * 1, all lower priority tasks are overloaded. Returns the hyperperiod of
+ * these tasks in 'hyperperiod', or 0 if it exceeds 'limit'. */
+static unsigned int feasible_prefix(TaskParams **params,
+                                    unsigned int number_of_tasks,
+                                    uint64_t limit, uint64_t *hyperperiod) {
+  uint64_t lcm = 1, demand = 0;
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    uint64_t period = params[i]->period;
+    uint64_t next_lcm;
+    if (__builtin_mul_overflow(lcm / gcd_u64(lcm, period), period,
+                               &next_lcm) ||
+        next_lcm > limit) {
+      *hyperperiod = 0;
+      return i;
+    }
+    // demand of tasks 0..i within one hyperperiod, never exceeds n * limit
+    demand = demand * (next_lcm / lcm) +
+             next_lcm / period * params[i]->execution_time;
+    if (demand > next_lcm) {
+      *hyperperiod = lcm;
+      return i;
+    }
+    lcm = next_lcm;
+  }
+  *hyperperiod = lcm;
+  return number_of_tasks;
+}
+
+bool fixed_priority_simulation(TaskParams **params,
+                               unsigned int number_of_tasks,
+                               uint64_t max_horizon,
+                               SimulationResult *results) {
+  uint64_t hyperperiod, offset = 0;
+
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    if (params[i]->release_time > offset)
+      offset = params[i]->release_time;
+  }
+  if (offset >= max_horizon)
+    return false;
+  unsigned int n = feasible_prefix(params, number_of_tasks,
+                                   (max_horizon - offset) / 2,
+                                   &hyperperiod);
+  if (hyperperiod == 0)
+    return false;
+
+  for (unsigned int i = n; i < number_of_tasks; i++) {
+    results[i].accepted = false;
+    results[i].response_time = 0;
+  }
+  if (n == 0)
+    return true;
+
+  SimulatedTask *tasks = pvPortMalloc(n * sizeof(SimulatedTask));
+  EventHeap releases = {.tasks = tasks, .by_release = true};
+  EventHeap ready = {.tasks = tasks, .by_release = false};
+  releases.heap = pvPortMalloc(n * sizeof(unsigned int));
+  ready.heap = pvPortMalloc(n * sizeof(unsigned int));
+  if (tasks == NULL || releases.heap == NULL || ready.heap == NULL) {
+    printf("ERROR: Memory allocation for fixed_priority_simulation failed\n");
+    vPortFree(tasks);
+    vPortFree(releases.heap);
+    vPortFree(ready.heap);
+    return false;
+  }
+
+  uint64_t horizon = offset + 2 * hyperperiod;
+  for (unsigned int i = 0; i < n; i++) {
+    tasks[i] = (SimulatedTask){.next_release = params[i]->release_time};
+    results[i].accepted = true;
+    results[i].response_time = 0;
+    heap_push(&releases, i);
+  }
+
+  uint64_t t = 0;
+  while (releases.size > 0 || ready.size > 0) {
+    // release all jobs that are due
+    while (releases.size > 0 && tasks[releases.heap[0]].next_release <= t) {
+      unsigned int j = releases.heap[0];
+      if (tasks[j].released == tasks[j].completed) {
+        tasks[j].remaining = params[j]->execution_time;
+        heap_push(&ready, j);
+      }
+      tasks[j].released++;
+      tasks[j].next_release += params[j]->period;
+      if (tasks[j].next_release >= horizon)
+        heap_pop(&releases);
+      else
+        heap_sift_down(&releases, 0);
+    }
+
+    // idle until the next release
+    if (ready.size == 0) {
+      if (releases.size > 0)
+        t = tasks[releases.heap[0]].next_release;
+      continue;
+    }
+
+    // run the highest priority job until it completes or a release happens
+    unsigned int i = ready.heap[0];
+    uint64_t run = tasks[i].remaining;
+    if (releases.size > 0 &&
+        tasks[releases.heap[0]].next_release - t < run)
+      run = tasks[releases.heap[0]].next_release - t;
+    t += run;
+    tasks[i].remaining -= run;
+    if (tasks[i].remaining > 0)
+      continue;
+
+    uint64_t response_time = t - params[i]->release_time -
+                             tasks[i].completed * params[i]->period;
+    if (response_time > results[i].response_time)
+      results[i].response_time = response_time;
+    if (response_time > params[i]->deadline)
+      results[i].accepted = false;
+
+    tasks[i].completed++;
+    if (tasks[i].completed == tasks[i].released)
+      heap_pop(&ready);
+    else
+      tasks[i].remaining = params[i]->execution_time;
+  }
+
+  vPortFree(tasks);
+  vPortFree(releases.heap);
+  vPortFree(ready.heap);
+  return true;
+}
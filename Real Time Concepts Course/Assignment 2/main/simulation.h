@@ -0,0 +1,31 @@
+#ifndef TDA_SIMULATION_H
+#define TDA_SIMULATION_H
+
+#include "tasks.h"
+
+// Longest schedule (in time units) that acceptance_test simulates
+#define SIMULATION_MAX_HORIZON 10000000ULL
+
+typedef struct {
+  bool accepted;            // all simulated jobs met their deadline
+  TickType_t response_time; // worst observed response time
+} SimulationResult;
+
+/* Event driven simulation of the fixed priority schedule of
+ * params[0..number_of_tasks-1], where index 0 has the highest priority and
+ * task i is first released at params[i]->release_time.
+ * The schedule only changes at job releases and completions, so the
+ * simulation jumps from one event to the next (including idle intervals)
+ * instead of stepping through every tick. Releases are kept in a min-heap.
+ * The first max(release_time) + 2 * hyperperiod time units are simulated,
+ * after which the schedule repeats [Leung & Whitehead 1982]. Tasks that push
+ * the utilization above 1 are rejected without simulation.
+ * - results: output array of size number_of_tasks
+ * Returns false if the simulation is inconclusive, i.e., the schedule is
+ * longer than 'max_horizon' or memory allocation fails. */
+bool fixed_priority_simulation(TaskParams **params,
+                               unsigned int number_of_tasks,
+                               uint64_t max_horizon,
+                               SimulationResult *results);
+
+#endif
@@ -1,23 +1,34 @@
 #include "tasks.h"
+#include "admission.h"
 
 /* No need to change anything here... */
 
 SemaphoreHandle_t useless_load_semaphore;
+static WorkloadKernel load_kernel;
+
+/* Useless load for 'duration' time slots. The task keeps the CPU busy with
+ * the calibrated kernel of task_setup for every slot it owns, except for
+ * the last half blink of a slot. It sleeps there, still owning the slot, so
+ * that the idle task feeds the task watchdog during loads of several
+ * seconds. */
 void task_useless_load(TaskParams *params, TickType_t duration) {
   TickType_t i;
   unsigned long j;
+  const TickType_t half_blink =
+      mainTASK_OUTPUT_FREQUENCY_MS / (2 * mainBLINK_PER_TICK);
+  uint64_t blink_cycles = workload_ms_to_cycles(pdTICKS_TO_MS(half_blink));
 
   for (i = 0; i < duration; ++i) {
     xSemaphoreTake(useless_load_semaphore, portMAX_DELAY);
-    TickType_t next_wake_time = xTaskGetTickCount();
-    printf("EXEC: Task %d (%ld/%ld)\n", params->id, params->elapsed_time + 1,
+    BINLOG("EXEC: Task %d (%ld/%ld)\n", params->id, params->elapsed_time + 1,
            params->execution_time);
     for (j = 0; j < mainBLINK_PER_TICK; ++j) {
-      vTaskDelayUntil(&next_wake_time,
-                      mainTASK_OUTPUT_FREQUENCY_MS / (2 * mainBLINK_PER_TICK));
+      workload_run(load_kernel, blink_cycles);
       gpio_set_level(params->gpio, 0);
-      vTaskDelayUntil(&next_wake_time,
-                      mainTASK_OUTPUT_FREQUENCY_MS / (2 * mainBLINK_PER_TICK));
+      if (j + 1 < mainBLINK_PER_TICK)
+        workload_run(load_kernel, blink_cycles);
+      else
+        vTaskDelay(half_blink);
       gpio_set_level(params->gpio, 1);
     }
     params->elapsed_time++;
@@ -28,26 +39,37 @@ void task_useless_load(TaskParams *params, TickType_t duration) {
 void task_implementation(void *v_params) {
   // cast needed as xTaskCreate expects void pointer in first arg
   TaskParams *params = (TaskParams *)v_params;
+  // parameters of the current job, updated by the admission control
+  TaskParams job = *params;
+
+  // first release after the offset (in seconds), as in Assignment 1
+  vTaskDelay(params->release_time * mainTASK_OUTPUT_FREQUENCY_MS);
 
   // indicate that task is ready
-  printf("RELEASE: Task %d\n", params->id);
+  BINLOG("RELEASE: Task %d\n", params->id);
   gpio_set_level(params->gpio, 1);
   TickType_t next_wake_time = xTaskGetTickCount();
-  const TickType_t period = params->period * mainTASK_OUTPUT_FREQUENCY_MS;
 
   for (;;) {
-    params->elapsed_time = 0;
-    task_useless_load(params, params->execution_time);
+    job.elapsed_time = 0;
+    task_useless_load(&job, job.execution_time);
     gpio_set_level(params->gpio, 0);
-    printf("COMPLETE: Task %d\n", params->id);
+    BINLOG("COMPLETE: Task %d\n", params->id);
 
-    vTaskDelayUntil(&next_wake_time, period);
-    printf("RELEASE: Task %d\n", params->id);
+    // leave the task set if the task was removed in the meantime,
+    // otherwise the period may have been updated by the admission control
+    if (!admission_job_complete(params, &job))
+      vTaskDelete(NULL);
+    vTaskDelayUntil(&next_wake_time, job.period * mainTASK_OUTPUT_FREQUENCY_MS);
+    BINLOG("RELEASE: Task %d\n", params->id);
     gpio_set_level(params->gpio, 1);
   }
 }
 
-void task_setup() {
+void task_setup(WorkloadKernel kernel) {
+  load_kernel = kernel;
+  workload_calibrate();
+
   gpio_config_t io_conf = {.pin_bit_mask = GPIO_PIN_BIT_MASK,
                            .mode = GPIO_MODE_OUTPUT,
                            .pull_up_en = 0,
@@ -3,6 +3,7 @@
 
 /* No need to change anything here... */
 
+#include "binlog.h"
 #include "driver/gpio.h"
 #include "esp_chip_info.h"
 #include "esp_flash.h"
@@ -10,6 +11,7 @@
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "sdkconfig.h"
+#include "workload.h"
 #include <inttypes.h>
 #include <stdio.h>
 
@@ -25,6 +27,7 @@
 
 typedef struct {
   char id;
+  TickType_t release_time;
   TickType_t execution_time;
   TickType_t period;
   TickType_t deadline;
@@ -34,6 +37,6 @@ typedef struct {
 
 void task_useless_load(TaskParams *params, TickType_t duration);
 void task_implementation(void *v_params);
-void task_setup();
+void task_setup(WorkloadKernel kernel);
 
 #endif
@@ -0,0 +1,280 @@
+#include "admission.h"
+#include "global.h"
+
+typedef struct {
+  bool remove_pending;
+  bool update_pending;
+  PeriodicTaskParams reserved; // parameters the admission decisions use
+} AdmissionSlot;
+
+// placeholder for free entries of the task table (handle stays NULL)
+static PeriodicTaskParams free_entry = {.period = 1, .deadline = 1};
+static PeriodicTaskParams *admitted[MAX_ADMITTED_TASKS];
+static AdmissionSlot slots[MAX_ADMITTED_TASKS];
+static Density densities[EDF_PARTITIONS];
+static PartitionHeuristic partition_heuristic;
+static SemaphoreHandle_t admission_mutex;
+
+// scratch space for the processor demand test, protected by admission_mutex
+static PeriodicTaskParams *demand_set[MAX_ADMITTED_TASKS + 1];
+static AcceptanceTestResult demand_results[MAX_ADMITTED_TASKS + 1];
+
+static int find_slot(PeriodicTaskParams *params) {
+  for (int i = 0; i < MAX_ADMITTED_TASKS; i++) {
+    if (admitted[i] == params)
+      return i;
+  }
+  return -1;
+}
+
+// whether slot 'i' is admitted to 'partition' and not replaced by the task
+static bool in_partition(int i, unsigned int partition, int skip) {
+  return admitted[i] != &free_entry && i != skip &&
+         slots[i].reserved.partition == partition;
+}
+
+/* Recompute the density of 'partition' from scratch (without slot 'skip') to
+ * shrink an lcm that grew too large */
+static bool recompute_density(unsigned int partition, int skip) {
+  Density fresh = empty_density;
+  for (int i = 0; i < MAX_ADMITTED_TASKS; i++) {
+    if (!in_partition(i, partition, skip))
+      continue;
+    if (!density_add(&fresh, slots[i].reserved.execution_time,
+                     density_denominator(&slots[i].reserved)))
+      return false;
+  }
+  densities[partition] = fresh;
+  return true;
+}
+
+/* Collect the tasks of the partition of 'task' except slot 'skip' (if
+ * skip >= 0) plus 'task' into demand_set. Returns the index of 'task'. */
+static TaskId collect_partition(PeriodicTaskParams *task, int skip) {
+  TaskId count = 0;
+  for (int i = 0; i < MAX_ADMITTED_TASKS; i++) {
+    if (!in_partition(i, task->partition, skip))
+      continue;
+    demand_set[count] = &slots[i].reserved;
+    demand_results[count++].accepted = true;
+  }
+  demand_set[count] = task;
+  demand_results[count] = default_result;
+  return count;
+}
+
+// Global EDF: the partition of all tasks runs on all cores, see global.h
+static bool global_test(PeriodicTaskParams *task, int skip) {
+  TaskId count = collect_partition(task, skip);
+  global_edf_test(demand_set, count, demand_results, EDF_CORES);
+  return demand_results[count].accepted;
+}
+
+/* Exact fallback if the density exceeds 1: run the processor demand test on
+ * the partition of 'task'. */
+static bool demand_test(PeriodicTaskParams *task, int skip,
+                        AcceptanceTestResult *result) {
+  TaskId count = collect_partition(task, skip);
+  processor_demand_test(demand_set, count, demand_results);
+  if (result != NULL) {
+    result->busy_period = demand_results[count].busy_period;
+    result->iterations = demand_results[count].iterations;
+  }
+  return demand_results[count].accepted;
+}
+
+/* Add the density of 'task' to its partition, where it replaces slot 'skip'
+ * (if skip >= 0). Returns false if neither the density test nor the
+ * processor demand test of the partition accepts it, or under global EDF,
+ * if global_edf_test rejects it. 'candidate' holds the density of the
+ * partition including the new term. */
+static bool reserve(PeriodicTaskParams *task, int skip, Density *candidate,
+                    AcceptanceTestResult *result) {
+  Density *density = &densities[task->partition];
+  *candidate = *density;
+  if (!density_add(candidate, task->execution_time,
+                   density_denominator(task))) {
+    if (recompute_density(task->partition, skip))
+      *candidate = *density;
+    if (!density_add(candidate, task->execution_time,
+                     density_denominator(task))) {
+      printf("ERROR: Density of the task set cannot be represented\n");
+      return false;
+    }
+  }
+  if (edf_mode() == EDF_GLOBAL && !global_test(task, skip))
+    return false;
+  if (edf_mode() != EDF_GLOBAL && candidate->numerator > candidate->lcm &&
+      !demand_test(task, skip, result))
+    return false;
+  *density = *candidate;
+  return true;
+}
+
+static unsigned int number_of_partitions() {
+  return edf_mode() == EDF_GLOBAL ? 1 : EDF_PARTITIONS;
+}
+
+/* Order in which the partitions are tried for a new task: by number for
+ * first fit, by increasing density for worst fit. */
+static void partition_order(unsigned int *order) {
+  for (unsigned int i = 0; i < number_of_partitions(); i++) {
+    // conversion is only needed for the order
+    double density = (double)densities[i].numerator / densities[i].lcm;
+    unsigned int j = i;
+    while (partition_heuristic == PARTITION_WORST_FIT && j > 0 &&
+           density < (double)densities[order[j - 1]].numerator /
+                         densities[order[j - 1]].lcm) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+  }
+}
+
+static void report(AcceptanceTestResult *result, bool accepted,
+                   Density *candidate) {
+  if (result == NULL)
+    return;
+  result->accepted = accepted;
+  // conversion is only needed for reporting
+  result->system_density = (double)candidate->numerator / candidate->lcm;
+}
+
+void admission_setup(PartitionHeuristic heuristic) {
+  for (int i = 0; i < MAX_ADMITTED_TASKS; i++) {
+    admitted[i] = &free_entry;
+  }
+  for (unsigned int i = 0; i < EDF_PARTITIONS; i++)
+    densities[i] = empty_density;
+  partition_heuristic = heuristic;
+  admission_mutex = xSemaphoreCreateMutex();
+}
+
+PeriodicTaskParams **admission_task_set() { return admitted; }
+
+bool admission_add(PeriodicTaskParams *params, AcceptanceTestResult *result) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  unsigned int order[EDF_PARTITIONS];
+  Density candidate = empty_density;
+  bool accepted = false;
+  if (result != NULL)
+    *result = default_result;
+  int slot = find_slot(&free_entry);
+  partition_order(order);
+  for (unsigned int i = 0; i < number_of_partitions() && !accepted; i++) {
+    params->partition = order[i];
+    accepted = slot >= 0 && find_slot(params) < 0 &&
+               reserve(params, -1, &candidate, result);
+  }
+  report(result, accepted, &candidate);
+  if (!accepted) {
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  slots[slot] = (AdmissionSlot){.reserved = *params};
+  // a partition is the core of its scheduler, global tasks migrate
+  BaseType_t core =
+      edf_mode() == EDF_GLOBAL ? tskNO_AFFINITY : (BaseType_t)params->partition;
+  if (IS_SERVER(params->type)) {
+    xTaskCreatePinnedToCore((void *)periodic_server_implementation, "PS",
+                            configMINIMAL_STACK_SIZE + 256, params,
+                            tskIDLE_PRIORITY, &params->handle, core);
+  } else {
+    char task_name[6];
+    snprintf(task_name, 6, "task%c", params->id);
+    xTaskCreatePinnedToCore((void *)periodic_task_implementation, task_name,
+                            configMINIMAL_STACK_SIZE + 256, params,
+                            tskIDLE_PRIORITY, &params->handle, core);
+  }
+  // publish the entry only once the handle is valid
+  admitted[slot] = params;
+  edf_task_changed(params->partition, slot);
+  xSemaphoreGive(admission_mutex);
+  return true;
+}
+
+unsigned int admission_add_set(PeriodicTaskParams **params,
+                               unsigned int number_of_tasks,
+                               AcceptanceTestResult *results) {
+  unsigned int number_admitted = 0;
+  partition_sort(params, number_of_tasks);
+  for (TaskId i = 0; i < number_of_tasks; i++)
+    number_admitted += admission_add(params[i], &results[i]);
+  return number_admitted;
+}
+
+bool admission_remove(PeriodicTaskParams *params) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  int slot = find_slot(params);
+  if (slot >= 0)
+    slots[slot].remove_pending = true;
+  xSemaphoreGive(admission_mutex);
+  return slot >= 0;
+}
+
+bool admission_update(PeriodicTaskParams *params, TickType_t execution_time,
+                      TickType_t period, TickType_t deadline,
+                      AcceptanceTestResult *result) {
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  if (result != NULL)
+    *result = default_result;
+  int slot = find_slot(params);
+  Density candidate =
+      slot >= 0 ? densities[slots[slot].reserved.partition] : empty_density;
+  if (slot < 0 || slots[slot].remove_pending) {
+    report(result, false, &candidate);
+    xSemaphoreGive(admission_mutex);
+    return false;
+  }
+
+  // swap the reserved density of the task for the new one
+  AdmissionSlot *pending = &slots[slot];
+  PeriodicTaskParams updated = pending->reserved;
+  updated.execution_time = execution_time;
+  updated.period = period;
+  updated.deadline = deadline;
+
+  // the task stays in its partition
+  Density *density = &densities[updated.partition];
+  Density previous = *density;
+  density_subtract(density, pending->reserved.execution_time,
+                   density_denominator(&pending->reserved));
+  bool accepted = reserve(&updated, slot, &candidate, result);
+  if (accepted) {
+    pending->update_pending = true;
+    pending->reserved = updated;
+  } else {
+    *density = previous;
+  }
+  report(result, accepted, &candidate);
+  xSemaphoreGive(admission_mutex);
+  return accepted;
+}
+
+bool admission_job_complete(PeriodicTaskParams *params) {
+  bool keep_running = true;
+  xSemaphoreTake(admission_mutex, portMAX_DELAY);
+  int slot = find_slot(params);
+  if (slot >= 0 && slots[slot].update_pending) {
+    params->execution_time = slots[slot].reserved.execution_time;
+    params->period = slots[slot].reserved.period;
+    params->deadline = slots[slot].reserved.deadline;
+    slots[slot].update_pending = false;
+    // a static schedule of the partition no longer applies
+    edf_task_changed(params->partition, slot);
+  }
+  if (slot >= 0 && slots[slot].remove_pending) {
+    density_subtract(&densities[params->partition], params->execution_time,
+                     density_denominator(params));
+    admitted[slot] = &free_entry;
+    params->handle = NULL;
+    edf_task_changed(params->partition, slot);
+    keep_running = false;
+  }
+  if (slot >= 0)
+    edf_job_complete(params->partition, slot);
+  xSemaphoreGive(admission_mutex);
+  return keep_running;
+}
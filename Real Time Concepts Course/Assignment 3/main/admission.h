@@ -0,0 +1,58 @@
+#ifndef EDF_ADMISSION_H
+#define EDF_ADMISSION_H
+
+#include "edf.h"
+#include "partition.h"
+#include "tasks.h"
+
+#define MAX_ADMITTED_TASKS 64
+
+/* Runtime admission control for the EDF scheduler.
+ * The service keeps the system density of the tasks admitted to each
+ * partition as an exact fraction, so adding, removing or updating a task
+ * costs O(1) instead of re-running system_density_test over the whole
+ * partition. Only if the density exceeds 1, the exact processor_demand_test
+ * is run on the new partition, so feasible constrained deadline sets are not
+ * rejected. Under global EDF (see edf_mode), every change runs
+ * global_edf_test on all tasks instead. Accepted tasks are created right
+ * away, pinned to the core of their partition unless global; removed or
+ * updated tasks only change when their current job is complete (see
+ * admission_job_complete). */
+
+/* 'heuristic' selects the partition of a new task, see partition.h */
+void admission_setup(PartitionHeuristic heuristic);
+
+/* Task table for edf_scheduler with MAX_ADMITTED_TASKS entries. Free entries
+ * point to a placeholder without a task handle, which the scheduler skips. */
+PeriodicTaskParams **admission_task_set();
+
+/* Admit 'params' to the first partition (in the order of the heuristic)
+ * whose system density stays <= 1, set params->partition and create its
+ * task. The caller keeps ownership of 'params'; it has to stay valid until
+ * the task is removed. */
+bool admission_add(PeriodicTaskParams *params, AcceptanceTestResult *result);
+
+/* First-fit or worst-fit decreasing: sort 'params' by decreasing density
+ * (partition_sort) and admit the tasks in this order. results[i] belongs to
+ * params[i] after sorting. Returns the number of admitted tasks. */
+unsigned int admission_add_set(PeriodicTaskParams **params,
+                               unsigned int number_of_tasks,
+                               AcceptanceTestResult *results);
+
+/* Request the removal of an admitted task. Its density is released when the
+ * task leaves after its current job. */
+bool admission_remove(PeriodicTaskParams *params);
+
+/* Change the parameters of an admitted task, which stays in its partition.
+ * The new density is checked and reserved right away, the parameters are
+ * applied after the current job. */
+bool admission_update(PeriodicTaskParams *params, TickType_t execution_time,
+                      TickType_t period, TickType_t deadline,
+                      AcceptanceTestResult *result);
+
+/* Called by every admitted task after each job. Applies pending updates,
+ * reports the completion to the EDF scheduler and returns false if the task
+ * was removed and has to delete itself. */
+bool admission_job_complete(PeriodicTaskParams *params);
+
+#endif
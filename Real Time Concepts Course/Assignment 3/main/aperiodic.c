@@ -0,0 +1,63 @@
+#include "aperiodic.h"
+#include "binlog.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+
+static AperiodicJob queue[APERIODIC_QUEUE_LENGTH];
+static uint32_t head; // written by the ISR only
+static uint32_t tail; // written by the server only
+static uint32_t dropped;
+static AperiodicStats stats;
+
+bool IRAM_ATTR aperiodic_request(AperiodicJobType type,
+                                 TickType_t execution_time) {
+  int64_t now = esp_timer_get_time();
+  uint32_t position = head;
+
+  if (position - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) ==
+      APERIODIC_QUEUE_LENGTH) {
+    dropped++;
+    return false;
+  }
+  queue[position % APERIODIC_QUEUE_LENGTH] =
+      (AperiodicJob){now, type, execution_time};
+  __atomic_store_n(&head, position + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool aperiodic_peek(AperiodicJob *job) {
+  uint32_t position = tail;
+  if (position == __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+    return false;
+  *job = queue[position % APERIODIC_QUEUE_LENGTH];
+  return true;
+}
+
+void aperiodic_pop() {
+  uint32_t position = tail;
+  if (position != __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+    __atomic_store_n(&tail, position + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t aperiodic_pending() {
+  return __atomic_load_n(&head, __ATOMIC_ACQUIRE) - tail;
+}
+
+void aperiodic_complete(const AperiodicJob *job) {
+  int64_t response_time = esp_timer_get_time() - job->arrival_time;
+  stats.served++;
+  stats.total_response_time += response_time;
+  if (response_time > stats.max_response_time)
+    stats.max_response_time = response_time;
+  BINLOG(" Aperiodic job %" PRIu32 ": response time %" PRIu32
+         " ms (max %" PRIu32 " ms)\n",
+         stats.served, (uint32_t)(response_time / 1000),
+         (uint32_t)(stats.max_response_time / 1000));
+}
+
+AperiodicStats aperiodic_stats() {
+  AperiodicStats current = stats;
+  current.dropped = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+  current.arrived = __atomic_load_n(&head, __ATOMIC_ACQUIRE) + current.dropped;
+  return current;
+}
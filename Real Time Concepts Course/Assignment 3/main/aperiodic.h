@@ -0,0 +1,50 @@
+#ifndef EDF_APERIODIC_H
+#define EDF_APERIODIC_H
+
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APERIODIC_QUEUE_LENGTH 16 // a power of two
+
+// the snowman job computes its frames for 900 ms, see run_aperiodic_job, so
+// it fits into the budget of 1 s the server has left when it starts
+#define APERIODIC_SNOWMAN_WCET_MS 950
+
+typedef enum { APERIODIC_SNOWMAN } AperiodicJobType;
+
+typedef struct {
+  int64_t arrival_time; // esp_timer_get_time() of the request, in us
+  AperiodicJobType type;
+  TickType_t execution_time; // WCET estimate in milliseconds
+} AperiodicJob;
+
+typedef struct {
+  uint32_t arrived;
+  uint32_t dropped; // the queue was full
+  uint32_t served;
+  int64_t total_response_time; // arrival to completion, in us
+  int64_t max_response_time;
+} AperiodicStats;
+
+/* Wait-free single producer, single consumer queue of aperiodic jobs.
+ * The button ISR is the only producer, the server task the only consumer,
+ * so head and tail each have a single writer and no lock is needed. */
+
+// ISR only: queue a job that arrives now; false if the queue is full
+bool aperiodic_request(AperiodicJobType type, TickType_t execution_time);
+
+// server only: the oldest queued job, without removing it
+bool aperiodic_peek(AperiodicJob *job);
+// server only: remove the job returned by aperiodic_peek
+void aperiodic_pop();
+
+uint32_t aperiodic_pending();
+
+/* server only: record the response time of a job the server finished,
+ * which is measured from the arrival in the ISR */
+void aperiodic_complete(const AperiodicJob *job);
+
+AperiodicStats aperiodic_stats();
+
+#endif
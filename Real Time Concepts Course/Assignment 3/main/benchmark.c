@@ -0,0 +1,64 @@
+#include "benchmark.h"
+#include "esp_cpu.h"
+
+typedef void (*DensityTest)(PeriodicTaskParams **params, TaskId task_id,
+                            AcceptanceTestResult *results);
+
+// Average cycles of a single call of 'test'
+static uint32_t benchmark_test(DensityTest test, PeriodicTaskParams **params,
+                               unsigned int number_of_tasks,
+                               unsigned int rounds,
+                               AcceptanceTestResult *results) {
+  uint32_t start = esp_cpu_get_cycle_count();
+  for (unsigned int r = 0; r < rounds; r++) {
+    for (TaskId i = 0; i < number_of_tasks; i++) {
+      results[i] = default_result;
+      test(params, i, results);
+    }
+  }
+  uint32_t cycles = esp_cpu_get_cycle_count() - start;
+  return cycles / (rounds * number_of_tasks);
+}
+
+void density_benchmark(PeriodicTaskParams **params,
+                       unsigned int number_of_tasks, unsigned int rounds) {
+  AcceptanceTestResult double_results[number_of_tasks];
+  AcceptanceTestResult int_results[number_of_tasks];
+
+  if (number_of_tasks == 0 || rounds == 0)
+    return;
+
+  uint32_t double_cycles = benchmark_test(system_density_test, params,
+                                          number_of_tasks, rounds,
+                                          double_results);
+  uint32_t int_cycles = benchmark_test(system_density_test_int, params,
+                                       number_of_tasks, rounds, int_results);
+
+  unsigned int differing = 0;
+  for (TaskId i = 0; i < number_of_tasks; i++) {
+    differing += double_results[i].accepted != int_results[i].accepted;
+  }
+  printf("BENCHMARK: %u tasks, %u rounds\n", number_of_tasks, rounds);
+  printf("BENCHMARK: density double %6" PRIu32 " cycles, int %6" PRIu32
+         " cycles, %u differing decisions\n",
+         double_cycles, int_cycles, differing);
+}
+
+void log_benchmark(unsigned int rounds) {
+  if (rounds == 0)
+    return;
+
+  uint32_t start = esp_cpu_get_cycle_count();
+  for (unsigned int r = 0; r < rounds; r++)
+    BINLOG(" Execute: Task %d (%lu ms)\n", 1, (unsigned long)r);
+  uint32_t binlog_cycles = (esp_cpu_get_cycle_count() - start) / rounds;
+
+  start = esp_cpu_get_cycle_count();
+  for (unsigned int r = 0; r < rounds; r++)
+    printf(" Execute: Task %d (%lu ms)\n", 1, (unsigned long)r);
+  uint32_t printf_cycles = (esp_cpu_get_cycle_count() - start) / rounds;
+
+  printf("BENCHMARK: %u log calls, BINLOG %6" PRIu32 " cycles, printf %6" PRIu32
+         " cycles\n",
+         rounds, binlog_cycles, printf_cycles);
+}
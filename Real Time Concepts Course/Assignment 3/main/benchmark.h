@@ -0,0 +1,18 @@
+#ifndef EDF_BENCHMARK_H
+#define EDF_BENCHMARK_H
+
+#include "edf.h"
+
+/* Microbenchmark of the floating point system density test against its
+ * integer counterpart. The test is run 'rounds' times for every task of
+ * params[0..number_of_tasks-1] and the average number of CPU cycles per call
+ * is printed, together with the number of differing decisions. */
+void density_benchmark(PeriodicTaskParams **params,
+                       unsigned int number_of_tasks, unsigned int rounds);
+
+/* Average CPU cycles of a BINLOG call against the same message printed with
+ * printf, 'rounds' times each. 'rounds' should stay below
+ * BINLOG_RING_LENGTH, so no record is dropped. */
+void log_benchmark(unsigned int rounds);
+
+#endif
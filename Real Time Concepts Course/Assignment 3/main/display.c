@@ -1,6 +1,29 @@
 #include "display.h"
+#include <string.h>
 
 ssd1306_handle_t ssd1306_dev = NULL;
+Framebuffer framebuffer;
+
+#define SNOWFLAKES 40
+#define SNOWMAN_CACHE_SIZE 4096
+
+// pre-rendered frames of the aperiodic job, see build_snowman_animation
+static uint8_t snowman_cache[SNOWMAN_CACHE_SIZE];
+static Animation snowman_animation;
+
+typedef enum { PAGE_SNOWMAN, PAGE_SENSITIVITY } DisplayPage;
+
+typedef struct {
+  DisplayPage page;
+  union {
+    unsigned int frame;
+    SensitivityInfo sensitivity;
+  };
+} DisplaySnapshot;
+
+static void build_snowman_animation();
+static void render_page(const void *snapshot);
+
 void ssd1306_setup() {
   i2c_config_t conf;
   conf.mode = I2C_MODE_MASTER;
@@ -16,8 +39,13 @@ void ssd1306_setup() {
 
   // deprecated, you can get bonus points for updating it ;-)
   ssd1306_dev = ssd1306_create(I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
-  ssd1306_refresh_gram(ssd1306_dev);
-  ssd1306_clear_screen(ssd1306_dev, 0x00);
+  // only changed page segments are sent from here on, see framebuffer.h
+  framebuffer_init(&framebuffer, I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
+  build_snowman_animation();
+  // from here on, only the display server talks to the display
+  display_server_start(render_page, sizeof(DisplaySnapshot),
+                       DISPLAY_SERVER_PRIORITY,
+                       pdMS_TO_TICKS(1000UL / DISPLAY_MAX_FRAME_RATE));
 }
 
 const unsigned char snowflake_bitmap[] = {0xff, 0x00, 0xff, 0x00, 0xff,
@@ -110,14 +138,96 @@ const unsigned char snowman_bitmap[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00};
 
-void ssd1306_print_aperiodic_task() {
-  for (int i = 0; i < 10; i++) {
-    ssd1306_clear_screen(ssd1306_dev, 0x00);
-    ssd1306_draw_bitmap(ssd1306_dev, 0, 0, snowman_bitmap, 128, 64);
-    for (int j = 0; j < 40; j++) {
-      ssd1306_fill_point(ssd1306_dev, rand() % 128, rand() % 64, 1);
+/* Render the frames once, with the snowflakes at random positions, and
+ * store them as deltas. A job then only decodes the changed bytes of every
+ * frame instead of redrawing the 1 KB bitmap. The framebuffer is used for
+ * drawing, so this has to run before the display server is started. */
+static void build_snowman_animation() {
+  uint8_t(*previous)[FRAMEBUFFER_WIDTH] =
+      pvPortMalloc(sizeof(framebuffer.pixels));
+  if (previous == NULL) {
+    printf("ERROR: Could not allocate the snowman animation\n");
+    return;
+  }
+
+  animation_init(&snowman_animation, snowman_cache, SNOWMAN_CACHE_SIZE);
+  for (int i = 0; i < SNOWMAN_FRAMES; i++) {
+    framebuffer_clear(&framebuffer);
+    framebuffer_draw_bitmap(&framebuffer, 0, 0, snowman_bitmap, 128, 64);
+    for (int j = 0; j < SNOWFLAKES; j++) {
+      framebuffer_fill_point(&framebuffer, rand() % 128, rand() % 64, 1);
+    }
+    if (!animation_add_frame(&snowman_animation, i > 0 ? previous : NULL,
+                             framebuffer.pixels)) {
+      printf("ERROR: Snowman frame %d exceeds the animation cache\n", i);
+      break;
     }
-    ssd1306_refresh_gram(ssd1306_dev);
-    vTaskDelay(pdMS_TO_TICKS(100UL));
+    memcpy(previous, framebuffer.pixels, sizeof(framebuffer.pixels));
+  }
+  if (DISPLAY_SERVER_TRAFFIC_REPORT) {
+    printf("DISPLAY: %u snowman frames cached in %u bytes\n",
+           snowman_animation.frames, snowman_animation.size);
+  }
+
+  vPortFree(previous);
+  framebuffer_clear(&framebuffer);
+}
+
+static void render_sensitivity(const SensitivityInfo *info) {
+  char val[24]; // fits any unsigned long
+  framebuffer_clear(&framebuffer);
+
+  // print task name
+  snprintf(val, sizeof(val), "Task %d: (%lu,%lu)", info->id, info->period,
+           info->execution_time);
+  framebuffer_draw_string(&framebuffer, 10, 0, val, 16, 1);
+
+  // print largest schedulable execution time
+  framebuffer_draw_string(&framebuffer, 10, 16, "Cmax:", 16, 1);
+  if (info->max_execution_time > 0) {
+    snprintf(val, sizeof(val), "%lu", info->max_execution_time);
+    framebuffer_draw_string(&framebuffer, 70, 16, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 16, "-", 16, 1);
+  }
+
+  // print smallest schedulable period
+  framebuffer_draw_string(&framebuffer, 10, 32, "Tmin:", 16, 1);
+  if (info->min_period > 0) {
+    snprintf(val, sizeof(val), "%lu", info->min_period);
+    framebuffer_draw_string(&framebuffer, 70, 32, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 32, "-", 16, 1);
+  }
+
+  // print breakdown utilization of the partition
+  framebuffer_draw_string(&framebuffer, 10, 48, "Ubd:", 16, 1);
+  if (info->breakdown_util > 0) {
+    snprintf(val, sizeof(val), "%.03f", info->breakdown_util);
+    framebuffer_draw_string(&framebuffer, 70, 48, val, 16, 1);
+  } else {
+    framebuffer_draw_string(&framebuffer, 70, 48, "-", 16, 1);
+  }
+
+  display_server_flush(&framebuffer);
+}
+
+static void render_page(const void *snapshot) {
+  const DisplaySnapshot *page = snapshot;
+  if (page->page == PAGE_SNOWMAN) {
+    animation_show_frame(&snowman_animation, &framebuffer, page->frame);
+    display_server_flush(&framebuffer);
+  } else {
+    render_sensitivity(&page->sensitivity);
   }
 }
+
+void ssd1306_print_snowman_frame(unsigned int frame) {
+  DisplaySnapshot snapshot = {.page = PAGE_SNOWMAN, .frame = frame};
+  display_server_post(&snapshot);
+}
+
+void ssd1306_print_sensitivity(const SensitivityInfo *info) {
+  DisplaySnapshot snapshot = {.page = PAGE_SENSITIVITY, .sensitivity = *info};
+  display_server_post(&snapshot);
+}
@@ -3,6 +3,9 @@
 
 /* No need to change anything here... */
 
+#include "animation.h"
+#include "display_server.h"
+#include "framebuffer.h"
 #include "freertos/FreeRTOS.h"
 #include "sdkconfig.h"
 #include "ssd1306.h"
@@ -13,7 +16,24 @@
 #define I2C_MASTER_NUM I2C_NUM_1
 #define I2C_MASTER_FREQ_HZ 100000
 
+#define DISPLAY_MAX_FRAME_RATE 12 // above the snowman frame rate
+
+// the snowman animation of the aperiodic job
+#define SNOWMAN_FRAMES 10
+#define SNOWMAN_FRAME_MS 90 // computation of a frame by the job
+
+// a page of the sensitivity analysis of a task, see density_sensitivity
+typedef struct {
+  char id;
+  TickType_t execution_time;
+  TickType_t period;
+  TickType_t max_execution_time;
+  TickType_t min_period;
+  double breakdown_util; // of the partition of the task
+} SensitivityInfo;
+
 void ssd1306_setup();
-void ssd1306_print_aperiodic_task();
+void ssd1306_print_snowman_frame(unsigned int frame);
+void ssd1306_print_sensitivity(const SensitivityInfo *info);
 
 #endif
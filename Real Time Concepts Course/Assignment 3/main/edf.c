@@ -9,7 +9,13 @@
 
 #include <stdio.h>
 #include "edf.h"
+#include "aperiodic.h"
+#include "cyclestat.h"
+#include "schedule_table.h"
+#include "esp_timer.h"
+#include <limits.h>
 #include <math.h>
+#include <string.h>
 
 /* Iterative system density test for EDF. For 'task_id', it determines
  * whether all previously accepted tasks of params[0..task_id] remain
@@ -29,12 +35,7 @@ void system_density_test(PeriodicTaskParams **params, TaskId task_id,
      *    To get this information, use 'results[i]->accepted' for i < task_id.
      */
     if(results[i].accepted){
-      if(params[i]->period<params[i]->deadline){
-        system_density+=params[i]->execution_time/(double)params[i]->period;
-      }
-      else{
-        system_density+=params[i]->execution_time/(double)params[i]->deadline;
-      }
+      system_density+=params[i]->execution_time/(double)density_denominator(params[i]);
     }
   }
   // TODO: adjust 'accepted' according to the system density.
@@ -43,115 +44,1472 @@ void system_density_test(PeriodicTaskParams **params, TaskId task_id,
   // it running like this for, let's say, 70 seconds?
   
 
-  if(params[task_id]->period<params[task_id]->deadline){
-    system_density+=params[task_id]->execution_time/(double)params[task_id]->period;
+  // min(D, T) for tasks, the reserved bandwidth for bandwidth servers
+  system_density+=params[task_id]->execution_time/(double)density_denominator(params[task_id]);
+  accepted = system_density <= 1 ? true : false;
+
+  results[task_id].system_density = system_density;
+  results[task_id].accepted = accepted;
+}
+
+static uint64_t div_ceil_u64(uint64_t x, uint64_t y) {
+  return x / y + (x % y != 0);
+}
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+  while (b != 0) {
+    uint64_t r = a % b;
+    a = b;
+    b = r;
   }
-  else{
-    system_density+=params[task_id]->execution_time/(double)params[task_id]->deadline;
+  return a;
+}
+
+TickType_t density_denominator(PeriodicTaskParams *params) {
+  // the deadlines of a bandwidth server follow from its period
+  if (IS_BANDWIDTH_SERVER(params->type))
+    return params->period;
+  return params->period < params->deadline ? params->period : params->deadline;
+}
+
+bool density_add(Density *density, TickType_t execution_time,
+                 TickType_t denominator) {
+  uint64_t scale = denominator / gcd_u64(density->lcm, denominator);
+  uint64_t numerator, lcm, term;
+  // lcm' = lcm(lcm, d), numerator' = numerator * (lcm' / lcm) + C * (lcm' / d)
+  if (__builtin_mul_overflow(density->numerator, scale, &numerator) ||
+      __builtin_mul_overflow(density->lcm, scale, &lcm) ||
+      __builtin_mul_overflow((uint64_t)execution_time, lcm / denominator,
+                             &term) ||
+      __builtin_add_overflow(numerator, term, &numerator))
+    return false;
+  density->numerator = numerator;
+  density->lcm = lcm;
+  return true;
+}
+
+void density_subtract(Density *density, TickType_t execution_time,
+                      TickType_t denominator) {
+  // the lcm is a multiple of every denominator that was added before
+  density->numerator -= execution_time * (density->lcm / denominator);
+  if (density->numerator == 0)
+    density->lcm = 1;
+}
+
+/* Integer version of system_density_test. The density is summed as an exact
+ * fraction over the lcm of all min(D, T), so the comparison with 1 is free of
+ * rounding. Should the lcm overflow, every term is rounded up in Q32 fixed
+ * point instead, which can only make the test more pessimistic. */
+void system_density_test_int(PeriodicTaskParams **params, TaskId task_id,
+                             AcceptanceTestResult *results) {
+  Density density = empty_density;
+  uint64_t numerator, lcm;
+  bool exact = true, accepted;
+
+  for (TaskId i = 0; i <= task_id && exact; i++) {
+    if (i < task_id && !results[i].accepted)
+      continue;
+    exact = density_add(&density, params[i]->execution_time,
+                        density_denominator(params[i]));
   }
-  accepted = system_density <= 1 ? true : false;
 
-  printf("Task %d: density %f, accepted %s\n", params[task_id]->id,
-         system_density, accepted ? "true" : "false");
+  if (exact) {
+    numerator = density.numerator;
+    lcm = density.lcm;
+    accepted = numerator <= lcm;
+  } else {
+    numerator = 0;
+    lcm = 1ULL << 32;
+    for (TaskId i = 0; i <= task_id; i++) {
+      if (i < task_id && !results[i].accepted)
+        continue;
+      uint64_t d = density_denominator(params[i]);
+      uint64_t term = ((uint64_t)params[i]->execution_time << 32) / d +
+                      (((uint64_t)params[i]->execution_time << 32) % d != 0);
+      if (__builtin_add_overflow(numerator, term, &numerator))
+        numerator = UINT64_MAX;
+    }
+    accepted = numerator <= lcm;
+  }
 
-  results[task_id].system_density = system_density;
+  // conversion is only needed for reporting
+  results[task_id].system_density = (double)numerator / lcm;
   results[task_id].accepted = accepted;
 }
 
-/* No need to change anything below this point... */
+/* Deadline used in the demand bound function. A deferrable server may run
+ * its budget at the end of one period and again at the start of the next,
+ * which is covered by a release jitter of T_s - C_s. A task with jitter J
+ * has the same demand as a task with deadline D - J. Bandwidth servers get
+ * a deadline of T_s; a total bandwidth server is not counted in steps of
+ * its period, see demand_bound. */
+static int64_t demand_deadline(PeriodicTaskParams *params) {
+  if (params->type == PERIODIC_SERVER)
+    return (int64_t)params->deadline -
+           (int64_t)(params->period - params->execution_time);
+  if (IS_BANDWIDTH_SERVER(params->type))
+    return params->period;
+  return params->deadline;
+}
+
+static bool demand_included(AcceptanceTestResult *results, TaskId task_id,
+                            TaskId i) {
+  return i == task_id || results[i].accepted;
+}
+
+/* Demand bound function h(t) of all included tasks. The deadlines of a
+ * total bandwidth server are WCET / U_s apart, so its jobs with deadlines
+ * in an interval of length t demand at most U_s * t. */
+static uint64_t demand_bound(PeriodicTaskParams **params, TaskId task_id,
+                             AcceptanceTestResult *results, uint64_t t) {
+  uint64_t demand = 0;
+  for (TaskId i = 0; i <= task_id; i++) {
+    if (demand_included(results, task_id, i) &&
+        params[i]->type == TOTAL_BANDWIDTH_SERVER) {
+      demand += div_ceil_u64(t * params[i]->execution_time,
+                             params[i]->period);
+      continue;
+    }
+    int64_t deadline = demand_deadline(params[i]);
+    if (!demand_included(results, task_id, i) || (uint64_t)deadline > t)
+      continue;
+    demand += ((t - deadline) / params[i]->period + 1) *
+              params[i]->execution_time;
+  }
+  return demand;
+}
+
+/* Latest absolute deadline before t (0 if there is none). The demand of a
+ * total bandwidth server grows slower than t, so it adds no deadlines that
+ * have to be checked. */
+static uint64_t deadline_before(PeriodicTaskParams **params, TaskId task_id,
+                                AcceptanceTestResult *results, uint64_t t) {
+  uint64_t latest = 0;
+  for (TaskId i = 0; i <= task_id; i++) {
+    int64_t deadline = demand_deadline(params[i]);
+    if (!demand_included(results, task_id, i) ||
+        params[i]->type == TOTAL_BANDWIDTH_SERVER || (uint64_t)deadline >= t)
+      continue;
+    uint64_t d = (t - 1 - deadline) / params[i]->period * params[i]->period +
+                 deadline;
+    if (d > latest)
+      latest = d;
+  }
+  return latest;
+}
+
+void processor_demand_test(PeriodicTaskParams **params, TaskId task_id,
+                           AcceptanceTestResult *results) {
+  AcceptanceTestResult *result = &results[task_id];
+  Density utilization = empty_density, density = empty_density;
+  uint64_t slack = 0, busy_period = 0, next_busy_period = 0;
+  uint64_t min_deadline = UINT64_MAX;
+  uint64_t utilization_up = 0; // Q16, rounded up
+  uint64_t utilization_q32 = 0, density_q32 = 0; // rounded up
+  bool exact_utilization = true, exact_density = true;
+  bool constrained = false, total_bandwidth = false;
+
+  result->accepted = false;
+  result->busy_period = 0;
+  result->iterations = 0;
+
+  for (TaskId i = 0; i <= task_id; i++) {
+    if (!demand_included(results, task_id, i))
+      continue;
+    PeriodicTaskParams *task = params[i];
+    int64_t deadline = demand_deadline(task);
+    // the first job cannot even meet its own deadline
+    if (deadline < (int64_t)task->execution_time)
+      return;
+    exact_utilization &=
+        density_add(&utilization, task->execution_time, task->period);
+    exact_density &= density_add(&density, task->execution_time,
+                                 density_denominator(task));
+    // (T - D) * U for L_a, tasks with D >= T only make the bound larger
+    if ((uint64_t)deadline < task->period)
+      slack += div_ceil_u64((uint64_t)(task->period - deadline) *
+                                task->execution_time << 16,
+                            task->period);
+    utilization_up += div_ceil_u64((uint64_t)task->execution_time << 16,
+                                   task->period);
+    utilization_q32 += div_ceil_u64((uint64_t)task->execution_time << 32,
+                                    task->period);
+    density_q32 += div_ceil_u64((uint64_t)task->execution_time << 32,
+                                density_denominator(task));
+    constrained |= (uint64_t)deadline < task->period;
+    total_bandwidth |= task->type == TOTAL_BANDWIDTH_SERVER;
+    if ((uint64_t)deadline < min_deadline)
+      min_deadline = deadline;
+    busy_period += task->execution_time;
+  }
+  // conversion is only needed for reporting
+  result->system_density = exact_density
+                               ? (double)density.numerator / density.lcm
+                               : (double)density_q32 / (1ULL << 32);
+
+  /* Coprime periods overflow the exact fraction quickly. The utilization
+   * is then rounded up in Q32 like in system_density_test_int, so this
+   * test still accepts every set that one does. The demand bound below is
+   * computed in integers either way. */
+  if (exact_utilization ? utilization.numerator > utilization.lcm
+                        : utilization_q32 > 1ULL << 32)
+    return;
+  // implicit or arbitrary deadlines: EDF is optimal for U <= 1
+  if (!constrained) {
+    result->accepted = true;
+    return;
+  }
+
+  /* Aperiodic jobs of a total bandwidth server may all arrive at once, so
+   * periodic releases do not bound the busy period. Only L_a is used, which
+   * needs U < 1. */
+  if (total_bandwidth && utilization_up >= 1ULL << 16)
+    return;
+
+  // synchronous busy period L_b, finite since U <= 1
+  while (!total_bandwidth) {
+    next_busy_period = 0;
+    for (TaskId i = 0; i <= task_id; i++) {
+      if (!demand_included(results, task_id, i))
+        continue;
+      next_busy_period += div_ceil_u64(busy_period, params[i]->period) *
+                          params[i]->execution_time;
+    }
+    if (next_busy_period == busy_period)
+      break;
+    busy_period = next_busy_period;
+  }
+  result->busy_period = busy_period;
+
+  // L = min(L_a, L_b) with L_a = max(D_max, sum((T - D) * U) / (1 - U))
+  uint64_t limit = total_bandwidth ? UINT64_MAX : busy_period;
+  if (utilization_up < 1ULL << 16) {
+    uint64_t limit_a = div_ceil_u64(slack, (1ULL << 16) - utilization_up);
+    for (TaskId i = 0; i <= task_id; i++) {
+      if (demand_included(results, task_id, i) &&
+          (uint64_t)demand_deadline(params[i]) > limit_a)
+        limit_a = demand_deadline(params[i]);
+    }
+    if (limit_a < limit)
+      limit = limit_a;
+  }
+
+  // QPA: walk backwards from the last deadline before L
+  uint64_t t = deadline_before(params, task_id, results, limit);
+  uint64_t demand = demand_bound(params, task_id, results, t);
+  while (demand <= t && demand > min_deadline) {
+    if (demand < t)
+      t = demand;
+    else
+      t = deadline_before(params, task_id, results, t);
+    demand = demand_bound(params, task_id, results, t);
+    result->iterations++;
+  }
+  result->accepted = demand <= min_deadline;
+}
+
+// task parameters are in milliseconds, the scheduler works in microseconds
+#define MS_TO_US(ms) ((int64_t)(ms) * 1000)
+
+// budget a sporadic server used and gets back at 'time'
+typedef struct {
+  int64_t time;
+  int64_t amount;
+} Replenishment;
+
+#define SPORADIC_MAX_REPLENISHMENTS 4
+
+// deadlines the on-line slack computation steps through at most
+#define SLACK_ONLINE_MAX_DEADLINES 256
+// deadlines of a hyperperiod in a slack table, see SlackComputation
+#define SLACK_TABLE_MAX_ENTRIES 256
+// a slack stealer gets at most this budget per pass of the scheduler
+#define SLACK_MAX_US INT32_MAX
+
+/* A periodic task in the slack computation: its pending job and its later
+ * jobs, whose first deadline is 'deadline'. */
+typedef struct {
+  int64_t deadline;
+  int64_t execution_time;
+  int64_t period;
+  int64_t job_deadline; // of the last released job
+  int64_t remaining;    // of the last released job, 0 if complete
+  bool on_pattern;      // the last job is one of those of the slack table
+} SlackTask;
+
+// deadline of a slack table, relative to the start of the table
+typedef struct {
+  int64_t deadline;
+  int64_t demand;   // WCET of all deadlines of the table up to this one
+  int64_t min_idle; // least deadline - demand from this entry on
+} SlackTableEntry;
+
+#define EDF_SCHEDULER_STACK_SIZE (configMINIMAL_STACK_SIZE + 2048)
+
+/* Scheduler state of a slot of the task table. Bandwidth servers keep
+ * their budget and deadline between jobs. */
+typedef struct {
+  PeriodicTaskParams *params; // NULL if the slot is not scheduled
+  int64_t next_release;       // of a sporadic server: next replenishment
+  int64_t absolute_deadline;  // of the current job
+  int64_t remaining;          // budget left of the current job
+  bool pending;               // released and not complete yet
+  bool notified;              // released and has not reported completion
+  // sporadic server only
+  int64_t activation_time;
+  int64_t activation_budget; // including replenishments since activation
+  Replenishment replenishments[SPORADIC_MAX_REPLENISHMENTS];
+  unsigned int replenishment_count;
+} EDFJob;
+
+#define NOT_IN_HEAP UINT_MAX
+
+/* Indexed binary min-heap of slots. The ready queue is keyed on the absolute
+ * deadline of the current job, the release calendar on the next release.
+ * 'position' allows removing a slot in O(log n) when its task leaves. */
+typedef struct {
+  TaskId *heap;
+  unsigned int *position;
+  unsigned int size;
+  bool by_deadline;
+  EDFJob *jobs; // of the partition the heap belongs to
+} JobHeap;
+
+/* Scheduler state of a partition. Each partition keeps a job for every slot
+ * of the task table, so a slot that moves to another partition is never
+ * scheduled by both at once, and only its own scheduler task touches it.
+ * The slot sets are shared with the tasks of all cores. A partition runs
+ * up to 'cores' jobs at once: one if partitioned, EDF_CORES if global. */
+typedef struct {
+  EDFJob *jobs;
+  JobHeap ready_queue;
+  JobHeap release_calendar;
+  uint32_t *changed_slots;   // see edf_task_changed
+  uint32_t *completed_slots; // see edf_job_complete
+  uint32_t *server_slots;    // bandwidth servers, see activate_servers
+  uint32_t *released_slots;  // see notify_released
+  TaskId running_slots[EDF_CORES]; // NUMBER_OF_TASKS if unused
+  unsigned int cores;
+  TaskHandle_t scheduler_handle;
+  esp_timer_handle_t event_timer;
+  int64_t dispatch_time_us; // the running jobs got the processor
+  unsigned int id;
+  PeriodicTaskParams **params; // task table, shared by all partitions
+  // budgets of the running jobs for edf_remaining_budget, see budget_lock
+  PeriodicTaskParams *budget_owners[EDF_CORES];
+  int64_t budget_ends_us[EDF_CORES];
+  // static schedule, see schedule_table.h; NULL while the ready queue decides
+  const ScheduleTable *table;
+  TaskId *table_slots;      // slot of every task of the table
+  unsigned int table_entry; // of the current frame
+  int64_t table_base_us;    // time of start_ms 0 in the current cycle
+  int64_t frame_end_us;
+  // slack stealing, see SlackComputation
+  SlackTask *slack_tasks;
+  SlackTableEntry *slack_table;
+  unsigned int slack_table_size; // 0 if the slack is computed on-line
+  int64_t slack_table_base_us;
+  int64_t slack_hyperperiod_us;
+  int64_t slack_cycle_idle_us; // hyperperiod minus the WCET in it
+} EDFPartition;
+
+static EDFMode mode;
+static bool use_schedule_tables;
+static SlackComputation slack_computation;
+static unsigned int number_of_partitions;
+static EDFPartition partitions[EDF_PARTITIONS];
+static int64_t start_time_us; // common timebase of all partitions
+/* A global server may run on another core than the scheduler, so the
+ * budgets are published under a spinlock instead of vTaskSuspendAll. */
+static portMUX_TYPE budget_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// overhead of the scheduler, see cyclestat.h
+CYCLESTAT_SITE(pass_site, "edf_pass");
+CYCLESTAT_SITE(select_site, "edf_select");
+CYCLESTAT_SITE(priority_site, "edf_priority_set");
+CYCLESTAT_SITE(notify_site, "edf_notify");
+CYCLESTAT_SITE(slack_site, "edf_slack");
+
+static int64_t heap_key(JobHeap *heap, TaskId slot) {
+  return heap->by_deadline ? heap->jobs[slot].absolute_deadline
+                           : heap->jobs[slot].next_release;
+}
+
+// ties are broken by slot, so the order does not depend on the heap layout
+static bool heap_less(JobHeap *heap, TaskId a, TaskId b) {
+  int64_t key_a = heap_key(heap, a), key_b = heap_key(heap, b);
+  return key_a < key_b || (key_a == key_b && a < b);
+}
+
+static void heap_place(JobHeap *heap, unsigned int index, TaskId slot) {
+  heap->heap[index] = slot;
+  heap->position[slot] = index;
+}
+
+static void heap_sift_up(JobHeap *heap, unsigned int index) {
+  TaskId slot = heap->heap[index];
+  while (index > 0) {
+    unsigned int parent = (index - 1) / 2;
+    if (!heap_less(heap, slot, heap->heap[parent]))
+      break;
+    heap_place(heap, index, heap->heap[parent]);
+    index = parent;
+  }
+  heap_place(heap, index, slot);
+}
+
+static void heap_sift_down(JobHeap *heap, unsigned int index) {
+  TaskId slot = heap->heap[index];
+  while (true) {
+    unsigned int child = 2 * index + 1;
+    if (child >= heap->size)
+      break;
+    if (child + 1 < heap->size &&
+        heap_less(heap, heap->heap[child + 1], heap->heap[child]))
+      child++;
+    if (!heap_less(heap, heap->heap[child], slot))
+      break;
+    heap_place(heap, index, heap->heap[child]);
+    index = child;
+  }
+  heap_place(heap, index, slot);
+}
+
+static void heap_push(JobHeap *heap, TaskId slot) {
+  heap_place(heap, heap->size++, slot);
+  heap_sift_up(heap, heap->size - 1);
+}
+
+static void heap_remove(JobHeap *heap, TaskId slot) {
+  unsigned int index = heap->position[slot];
+  if (index == NOT_IN_HEAP)
+    return;
+  heap->position[slot] = NOT_IN_HEAP;
+  TaskId last = heap->heap[--heap->size];
+  if (index == heap->size)
+    return;
+  heap_place(heap, index, last);
+  heap_sift_up(heap, index);
+  heap_sift_down(heap, heap->position[last]);
+}
+
+static bool heap_init(JobHeap *heap, EDFJob *jobs, unsigned int capacity,
+                      bool by_deadline) {
+  heap->heap = pvPortMalloc(capacity * sizeof(TaskId));
+  heap->position = pvPortMalloc(capacity * sizeof(unsigned int));
+  heap->size = 0;
+  heap->by_deadline = by_deadline;
+  heap->jobs = jobs;
+  if (heap->heap == NULL || heap->position == NULL)
+    return false;
+  for (unsigned int i = 0; i < capacity; i++)
+    heap->position[i] = NOT_IN_HEAP;
+  return true;
+}
+
+static unsigned int slot_set_words() { return (NUMBER_OF_TASKS + 31) / 32; }
+
+/* Mark 'slot' in a set shared with the tasks and wake up the scheduler of
+ * the partition. The tasks of the other core mark the set as well, which
+ * vTaskSuspendAll does not hold off, so the words are updated atomically. */
+static void slot_set_mark(unsigned int partition, bool completed,
+                          TaskId slot) {
+  if (partition >= number_of_partitions || slot >= NUMBER_OF_TASKS)
+    return;
+  EDFPartition *target = &partitions[partition];
+  uint32_t *set = completed ? target->completed_slots : target->changed_slots;
+  if (set == NULL)
+    return;
+  __atomic_fetch_or(&set[slot / 32], 1UL << (slot % 32), __ATOMIC_RELEASE);
+  if (target->scheduler_handle != NULL)
+    xTaskNotifyGive(target->scheduler_handle);
+}
+
+static uint32_t slot_set_take(uint32_t *set, unsigned int word) {
+  return __atomic_exchange_n(&set[word], 0, __ATOMIC_ACQUIRE);
+}
+
+void edf_task_changed(unsigned int partition, TaskId slot) {
+  slot_set_mark(partition, false, slot);
+}
+
+void edf_job_complete(unsigned int partition, TaskId slot) {
+  slot_set_mark(partition, true, slot);
+}
+
+void IRAM_ATTR edf_aperiodic_arrival_from_isr() {
+  BaseType_t higher_priority_woken = pdFALSE;
+  // the server may be in any partition
+  for (unsigned int i = 0; i < number_of_partitions; i++) {
+    if (partitions[i].scheduler_handle != NULL)
+      vTaskNotifyGiveFromISR(partitions[i].scheduler_handle,
+                             &higher_priority_woken);
+  }
+  portYIELD_FROM_ISR(higher_priority_woken);
+}
+
+static void event_timer_callback(void *arg) {
+  EDFPartition *partition = (EDFPartition *)arg;
+  xTaskNotifyGive(partition->scheduler_handle);
+}
+
+// index of 'slot' in the running slots, 'cores' if it is not running
+static unsigned int running_index(EDFPartition *partition, TaskId slot) {
+  unsigned int core = 0;
+  while (core < partition->cores && partition->running_slots[core] != slot)
+    core++;
+  return core;
+}
+
+static void unschedule_slot(EDFPartition *partition, TaskId slot) {
+  heap_remove(&partition->ready_queue, slot);
+  heap_remove(&partition->release_calendar, slot);
+  unsigned int core = running_index(partition, slot);
+  if (core < partition->cores)
+    partition->running_slots[core] = NUMBER_OF_TASKS;
+  partition->server_slots[slot / 32] &= ~(1UL << (slot % 32));
+  partition->jobs[slot] = (EDFJob){.params = NULL};
+}
+
+/* Give the budget a sporadic server used since its activation back one
+ * period after the activation. If all entries are taken, the amount is
+ * merged into the latest one, which only delays it. */
+static void sporadic_schedule_replenishment(EDFPartition *partition,
+                                            TaskId slot) {
+  EDFJob *job = &partition->jobs[slot];
+  if (job->remaining < 0)
+    job->remaining = 0;
+  int64_t amount = job->activation_budget - job->remaining;
+  int64_t time = job->activation_time + MS_TO_US(job->params->period);
+  if (amount <= 0)
+    return;
+  if (job->replenishment_count == SPORADIC_MAX_REPLENISHMENTS) {
+    Replenishment *latest = &job->replenishments[job->replenishment_count - 1];
+    latest->time = time;
+    latest->amount += amount;
+    return;
+  }
+  job->replenishments[job->replenishment_count++] =
+      (Replenishment){time, amount};
+  if (job->replenishment_count == 1) {
+    job->next_release = time;
+    heap_push(&partition->release_calendar, slot);
+  }
+}
+
+// Add the replenishments of a sporadic server that are due to its budget
+static void sporadic_replenish(EDFPartition *partition, TaskId slot,
+                               int64_t current_time_us) {
+  EDFJob *job = &partition->jobs[slot];
+  unsigned int due = 0;
+  while (due < job->replenishment_count &&
+         job->replenishments[due].time <= current_time_us) {
+    job->remaining += job->replenishments[due].amount;
+    if (job->pending)
+      job->activation_budget += job->replenishments[due].amount;
+    due++;
+  }
+  job->replenishment_count -= due;
+  memmove(job->replenishments, &job->replenishments[due],
+          job->replenishment_count * sizeof(Replenishment));
+  if (job->replenishment_count == 0) {
+    heap_remove(&partition->release_calendar, slot);
+    return;
+  }
+  job->next_release = job->replenishments[0].time;
+  heap_sift_down(&partition->release_calendar,
+                 partition->release_calendar.position[slot]);
+}
+
+static void end_job(EDFPartition *partition, TaskId slot) {
+  EDFJob *job = &partition->jobs[slot];
+  switch (job->params->type) {
+  case SPORADIC_SERVER:
+    sporadic_schedule_replenishment(partition, slot);
+    break;
+  case CONSTANT_BANDWIDTH_SERVER:
+    break;
+  default:
+    job->remaining = 0;
+  }
+  job->pending = false;
+  heap_remove(&partition->ready_queue, slot);
+}
+
+static void apply_completions(EDFPartition *partition) {
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    uint32_t completed = slot_set_take(partition->completed_slots, word);
+    while (completed != 0) {
+      TaskId slot = word * 32 + __builtin_ctz(completed);
+      completed &= completed - 1;
+      partition->jobs[slot].notified = false;
+      // a server may complete after its budget already ended the job
+      if (partition->jobs[slot].pending)
+        end_job(partition, slot);
+    }
+  }
+}
+
+// end of the current frame of the static schedule
+static int64_t table_frame_end(EDFPartition *partition) {
+  const ScheduleTable *table = partition->table;
+  unsigned int next = partition->table_entry + 1;
+  uint32_t end_ms = next < table->number_of_entries
+                        ? table->entries[next].start_ms
+                        : table->cycle_start_ms + table->hyperperiod_ms;
+  return partition->table_base_us + MS_TO_US(end_ms);
+}
+
+/* Whether the tasks of 'partition' are exactly those of 'table' and all
+ * joined at 'current_time_us', so their releases line up with the table.
+ * Fills in the slots of the table tasks. */
+static bool table_matches(EDFPartition *partition, const ScheduleTable *table,
+                          int64_t current_time_us) {
+  EDFJob *jobs = partition->jobs;
+  unsigned int scheduled = 0;
+  for (TaskId slot = 0; slot < NUMBER_OF_TASKS; slot++)
+    scheduled += jobs[slot].params != NULL;
+  if (scheduled != table->number_of_tasks)
+    return false;
+  for (unsigned int i = 0; i < table->number_of_tasks; i++) {
+    const ScheduleTask *task = &table->tasks[i];
+    TaskId slot = 0;
+    while (slot < NUMBER_OF_TASKS &&
+           (jobs[slot].params == NULL || jobs[slot].params->id != task->id))
+      slot++;
+    if (slot == NUMBER_OF_TASKS)
+      return false;
+    PeriodicTaskParams *params = jobs[slot].params;
+    if (params->execution_time != task->execution_time ||
+        params->period != task->period || params->deadline != task->deadline ||
+        params->release_time != task->release_time ||
+        params->type != task->type || IS_BANDWIDTH_SERVER(params->type) ||
+        jobs[slot].pending ||
+        jobs[slot].next_release !=
+            current_time_us + MS_TO_US(task->release_time))
+      return false;
+    partition->table_slots[i] = slot;
+  }
+  return true;
+}
+
+/* Dispatch from the first table that matches the tasks of 'partition' from
+ * 'current_time_us' on, or from the ready queue if there is none. */
+static void table_attach(EDFPartition *partition, int64_t current_time_us) {
+  partition->table = NULL;
+  for (unsigned int i = 0; i < number_of_schedule_tables; i++) {
+    if (!table_matches(partition, &schedule_tables[i], current_time_us))
+      continue;
+    partition->table = &schedule_tables[i];
+    partition->table_entry = 0;
+    partition->table_base_us = current_time_us;
+    partition->frame_end_us = table_frame_end(partition);
+    BINLOG(" Core %u: static schedule %u\n", partition->id, i);
+    return;
+  }
+}
 
-/* Determine the next job to execute under EDF.
- * Unfortunately, this EDF implementation is rather 'hacky' to
- * avoid having to check for overruns (something that is a must-have
- * in practice, of course). */
-EDFInfo edf_select_next_job(PeriodicTaskParams **params,
-                            TickType_t current_time_sec) {
-  EDFInfo next_job = {NUMBER_OF_TASKS, ULONG_MAX, ULONG_MAX, false};
-  for (TaskId i = 0; i < NUMBER_OF_TASKS; i++) {
-    // skip deleted tasks
-    if (params[i]->handle == NULL)
+/* Gather the periodic tasks and deferrable servers of 'partition', i.e.,
+ * its release calendar without the bandwidth servers. Returns their
+ * number. */
+static unsigned int slack_gather(EDFPartition *partition) {
+  JobHeap *calendar = &partition->release_calendar;
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < calendar->size; i++) {
+    EDFJob *job = &partition->jobs[calendar->heap[i]];
+    PeriodicTaskParams *task = job->params;
+    if (IS_BANDWIDTH_SERVER(task->type))
       continue;
-    vTaskPrioritySet(params[i]->handle, taskIDLE_PRIORITY);
-
-    eTaskState state = eTaskGetState(params[i]->handle);
-    if (state == eReady) {
-      // When the task is ready, determine next deadline.
-      TickType_t deadline =
-          params[i]->deadline - (current_time_sec % params[i]->period);
-      printf(" State of Task%d: (deadline %lu, ready)\n", params[i]->id,
-             deadline);
-      if (params[i]->elapsed_time < params[i]->execution_time &&
-          deadline < next_job.earliest_deadline) {
-        next_job.earliest_deadline = deadline;
-        next_job.next_task_id = i;
-        if (params[i]->execution_time < next_job.next_scheduler_wakeup) {
-          next_job.next_scheduler_wakeup =
-              params[i]->execution_time - params[i]->elapsed_time;
-          next_job.run_to_completion = true;
-        }
+    partition->slack_tasks[count++] = (SlackTask){
+        .deadline = job->next_release + MS_TO_US(task->deadline),
+        .execution_time = MS_TO_US(task->execution_time),
+        .period = MS_TO_US(task->period),
+        .job_deadline = job->absolute_deadline,
+        // an overrun job runs on at its deadline, see account_running_job
+        .remaining = job->pending && job->remaining > 0 ? job->remaining : 0,
+    };
+  }
+  return count;
+}
+
+/* Slack at 'current_time_us' from the deadlines of the jobs, see
+ * SlackComputation. Past the deadline d reached so far, the jobs of a task
+ * with the next deadline d_i demand at most C * (t' - d_i + T) / T until
+ * t', which grows slower than t' for a utilization up to 1. So no later
+ * deadline has less slack than the bound at d. */
+static int64_t online_slack(EDFPartition *partition, int64_t current_time_us) {
+  SlackTask *tasks = partition->slack_tasks;
+  unsigned int count = slack_gather(partition);
+  int64_t demand = 0, pending = 0, slack = SLACK_MAX_US, bound = SLACK_MAX_US;
+
+  for (unsigned int i = 0; i < count; i++) {
+    // a late job delays every deadline
+    if (tasks[i].job_deadline <= current_time_us) {
+      demand += tasks[i].remaining;
+      tasks[i].remaining = 0;
+    }
+    pending += tasks[i].remaining;
+  }
+  for (unsigned int step = 0; step < SLACK_ONLINE_MAX_DEADLINES; step++) {
+    int64_t deadline = INT64_MAX;
+    for (unsigned int i = 0; i < count; i++) {
+      if (tasks[i].remaining > 0 && tasks[i].job_deadline < deadline)
+        deadline = tasks[i].job_deadline;
+      if (tasks[i].deadline < deadline)
+        deadline = tasks[i].deadline;
+    }
+    if (deadline == INT64_MAX)
+      return slack;
+    for (unsigned int i = 0; i < count; i++) {
+      if (tasks[i].remaining > 0 && tasks[i].job_deadline == deadline) {
+        demand += tasks[i].remaining;
+        pending -= tasks[i].remaining;
+        tasks[i].remaining = 0;
       }
-    } else if (state == eBlocked) {
-      // When the task is blocked, determine next release time.
-      // This is used to schedule the next wakeup time of the EDF scheduler.
-      TickType_t next_release =
-          params[i]->period - (current_time_sec % params[i]->period);
-      printf(" State of Task%d: (next release %lu, blocked)\n", params[i]->id,
-             next_release);
-      if (next_release < next_job.next_scheduler_wakeup) {
-        next_job.next_scheduler_wakeup = next_release;
-        next_job.run_to_completion = false;
+      if (tasks[i].deadline == deadline) {
+        demand += tasks[i].execution_time;
+        tasks[i].deadline += tasks[i].period;
       }
     }
+    if (deadline - current_time_us - demand < slack)
+      slack = deadline - current_time_us - demand;
+
+    bound = deadline - current_time_us - demand - pending;
+    for (unsigned int i = 0; i < count; i++) {
+      int64_t overlap = deadline - tasks[i].deadline + tasks[i].period;
+      if (overlap > 0)
+        bound -= div_ceil_u64(tasks[i].execution_time * overlap,
+                              tasks[i].period);
+    }
+    if (bound >= slack)
+      return slack;
   }
+  return bound < slack ? bound : slack;
+}
 
-  return next_job;
+/* Precompute the deadlines of the tasks of 'partition' over one hyperperiod
+ * from 'current_time_us' on, with the demand up to each of them and the
+ * least idle time deadline - demand from each of them on. The next
+ * hyperperiod repeats the table with slack_cycle_idle_us more idle time. */
+static void slack_table_build(EDFPartition *partition,
+                              int64_t current_time_us) {
+  SlackTask *tasks = partition->slack_tasks;
+  SlackTableEntry *table = partition->slack_table;
+  unsigned int count = slack_gather(partition);
+  uint64_t hyperperiod = 1, entries = 0;
+  int64_t idle;
+
+  partition->slack_table_size = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    hyperperiod = hyperperiod / gcd_u64(hyperperiod, tasks[i].period) *
+                  tasks[i].period;
+    if (hyperperiod > (uint64_t)MS_TO_US(UINT32_MAX))
+      return;
+  }
+  idle = hyperperiod;
+  for (unsigned int i = 0; i < count; i++) {
+    entries += hyperperiod / tasks[i].period;
+    idle -= hyperperiod / tasks[i].period * tasks[i].execution_time;
+    // the first deadline of the task from now on, maybe of its pending job
+    int64_t offset = (tasks[i].deadline - current_time_us) % tasks[i].period;
+    tasks[i].deadline =
+        current_time_us + (offset < 0 ? offset + tasks[i].period : offset);
+  }
+  if (entries == 0 || entries > SLACK_TABLE_MAX_ENTRIES || idle < 0)
+    return;
+
+  int64_t demand = 0;
+  for (unsigned int entry = 0; entry < entries; entry++) {
+    unsigned int first = 0;
+    for (unsigned int i = 1; i < count; i++) {
+      if (tasks[i].deadline < tasks[first].deadline)
+        first = i;
+    }
+    demand += tasks[first].execution_time;
+    table[entry] = (SlackTableEntry){
+        .deadline = tasks[first].deadline - current_time_us,
+        .demand = demand};
+    tasks[first].deadline += tasks[first].period;
+  }
+  // over two hyperperiods, the least idle time from the later entries on
+  int64_t min_idle = INT64_MAX;
+  for (unsigned int entry = 2 * entries; entry-- > 0;) {
+    SlackTableEntry *current = &table[entry % entries];
+    int64_t entry_idle = current->deadline - current->demand +
+                         (entry >= entries ? idle : 0);
+    if (entry_idle < min_idle)
+      min_idle = entry_idle;
+    if (entry < entries)
+      current->min_idle = min_idle;
+  }
+  partition->slack_table_size = entries;
+  partition->slack_table_base_us = current_time_us;
+  partition->slack_hyperperiod_us = hyperperiod;
+  partition->slack_cycle_idle_us = idle;
+  BINLOG(" Core %u: slack table of %u deadlines\n", partition->id,
+         (unsigned int)entries);
 }
 
-void edf_scheduler(PeriodicTaskParams **params) {
-  printf("State Information: Running %d, Ready %d, Blocked %d, Suspended %d, "
-         "Deleted %d\n",
-         eRunning, eReady, eBlocked, eSuspended, eDeleted);
+// number of deadlines of the slack table up to 'offset' into the hyperperiod
+static unsigned int slack_table_count(EDFPartition *partition,
+                                      int64_t offset) {
+  unsigned int low = 0, high = partition->slack_table_size;
+  while (low < high) {
+    unsigned int middle = (low + high) / 2;
+    if (partition->slack_table[middle].deadline <= offset)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
 
-  vTaskPrioritySet(NULL, schedulerPRIORITY);
-  TickType_t current_time_sec = 0;
+/* Time since the start of the table minus the WCET of its deadlines up to
+ * 'time'. The slack until a deadline d after t is idle(d) - idle(t),
+ * corrected for the jobs released before t. */
+static int64_t slack_table_idle(EDFPartition *partition, int64_t time) {
+  int64_t elapsed = time - partition->slack_table_base_us;
+  int64_t cycles = elapsed / partition->slack_hyperperiod_us;
+  int64_t offset = elapsed % partition->slack_hyperperiod_us;
+  unsigned int count = slack_table_count(partition, offset);
+  int64_t demand = count > 0 ? partition->slack_table[count - 1].demand : 0;
+  return cycles * partition->slack_cycle_idle_us + offset - demand;
+}
+
+// least slack_table_idle at the deadlines of the table after 'time'
+static int64_t slack_table_min_idle(EDFPartition *partition, int64_t time) {
+  int64_t elapsed = time - partition->slack_table_base_us;
+  int64_t cycles = elapsed / partition->slack_hyperperiod_us;
+  int64_t offset = elapsed % partition->slack_hyperperiod_us;
+  unsigned int next = slack_table_count(partition, offset);
+  if (next == partition->slack_table_size) {
+    next = 0;
+    cycles++;
+  }
+  return partition->slack_table[next].min_idle +
+         cycles * partition->slack_cycle_idle_us;
+}
+
+/* Least slack_table_idle at the deadlines of the table in (start, end),
+ * and at 'start' if it is the deadline of a job. Steps through the
+ * deadlines in between, at most '*budget' of them; once they are used up,
+ * the least idle time after 'start' is a lower bound. INT64_MAX if there is
+ * no deadline. */
+static int64_t slack_table_least_idle(EDFPartition *partition, int64_t start,
+                                      int64_t end, bool at_deadline,
+                                      unsigned int *budget) {
+  int64_t elapsed = start - partition->slack_table_base_us;
+  int64_t cycles = elapsed / partition->slack_hyperperiod_us;
+  unsigned int next =
+      slack_table_count(partition, elapsed % partition->slack_hyperperiod_us);
+  int64_t least =
+      at_deadline ? slack_table_idle(partition, start) : INT64_MAX;
+
+  if (end == INT64_MAX) {
+    int64_t later = slack_table_min_idle(partition, start);
+    return later < least ? later : least;
+  }
   while (true) {
-    printf("Time %lu\n", current_time_sec);
-
-    // Check if there are new jobs to be released
-    for (TaskId i = 0; i < NUMBER_OF_TASKS; i++) {
-      if (params[i]->handle != NULL &&
-          current_time_sec % params[i]->period == 0) {
-        printf(" Release Task %d\n", params[i]->id);
-        if (params[i]->elapsed_time != 0) {
-          printf("OVERRUN DETECTED: Task %d did not reset correctly!\n",
-                 params[i]->id);
-          abort();
-        }
-        vTaskNotifyGiveFromISR(params[i]->handle, NULL);
+    if (*budget == 0) {
+      int64_t later = slack_table_min_idle(partition, start);
+      return later < least ? later : least;
+    }
+    if (next == partition->slack_table_size) {
+      next = 0;
+      cycles++;
+    }
+    SlackTableEntry *entry = &partition->slack_table[next++];
+    int64_t offset = cycles * partition->slack_hyperperiod_us + entry->deadline;
+    if (partition->slack_table_base_us + offset >= end)
+      return least;
+    int64_t idle = cycles * partition->slack_cycle_idle_us + entry->deadline -
+                   entry->demand;
+    if (idle < least)
+      least = idle;
+    (*budget)--;
+  }
+}
+
+/* Slack at 'current_time_us' from the slack table. The table counts the
+ * WCET of every job; the last job of a task, which has run in part or
+ * completely, is corrected from its deadline on. Up to the last of these
+ * deadlines, the deadlines of the table are stepped through, after it the
+ * least idle time of the table is looked up. Deadlines before the first
+ * one with demand left constrain nothing. */
+static int64_t table_slack(EDFPartition *partition, int64_t current_time_us) {
+  SlackTask *tasks = partition->slack_tasks;
+  unsigned int count = slack_gather(partition);
+  unsigned int budget = partition->slack_table_size;
+  int64_t late = 0, correction = 0, slack = INT64_MAX;
+  int64_t first_demand = INT64_MAX; // no constraint before it
+
+  for (unsigned int i = 0; i < count; i++) {
+    SlackTask *task = &tasks[i];
+    int64_t offset = (task->job_deadline - partition->slack_table_base_us) %
+                     task->period;
+    int64_t first = (task->deadline - partition->slack_table_base_us) %
+                    task->period;
+    task->on_pattern = task->job_deadline >= partition->slack_table_base_us &&
+                       offset == (first < 0 ? first + task->period : first);
+    // a late job delays every deadline
+    if (task->job_deadline <= current_time_us) {
+      late += task->remaining;
+      task->remaining = 0;
+      task->job_deadline = INT64_MAX;
+    }
+    if (task->remaining > 0 && task->job_deadline < first_demand)
+      first_demand = task->job_deadline;
+    if (task->deadline < first_demand)
+      first_demand = task->deadline;
+  }
+  if (late > 0)
+    first_demand = current_time_us;
+  // correct the last jobs in the order of their deadlines
+  for (unsigned int i = 1; i < count; i++) {
+    SlackTask task = tasks[i];
+    unsigned int j = i;
+    while (j > 0 && tasks[j - 1].job_deadline > task.job_deadline) {
+      tasks[j] = tasks[j - 1];
+      j--;
+    }
+    tasks[j] = task;
+  }
+  int64_t start = current_time_us;
+  unsigned int next = 0;
+  while (true) {
+    while (next < count && tasks[next].job_deadline == start) {
+      correction += (tasks[next].on_pattern ? tasks[next].execution_time : 0) -
+                    tasks[next].remaining;
+      next++;
+    }
+    int64_t end = next < count ? tasks[next].job_deadline : INT64_MAX;
+    int64_t least =
+        end <= first_demand
+            ? INT64_MAX
+            : start < first_demand
+                  ? slack_table_least_idle(partition, first_demand - 1, end,
+                                           false, &budget)
+                  : slack_table_least_idle(partition, start, end,
+                                           start != current_time_us, &budget);
+    if (least != INT64_MAX && least + correction < slack)
+      slack = least + correction;
+    if (end == INT64_MAX)
+      break;
+    start = end;
+  }
+  return slack - slack_table_idle(partition, current_time_us) - late;
+}
+
+/* Give the pending slack stealers of 'partition' the current slack as their
+ * budget. A stealer runs at the head of the ready queue while it has
+ * slack, and outside of it until slack is left again. Any pass can change
+ * the slack, a job that completes early adds to it. */
+static void steal_slack(EDFPartition *partition, int64_t current_time_us) {
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    uint32_t servers = partition->server_slots[word];
+    while (servers != 0) {
+      TaskId slot = word * 32 + __builtin_ctz(servers);
+      servers &= servers - 1;
+      EDFJob *job = &partition->jobs[slot];
+      if (job->params->type != SLACK_STEALER || !job->pending)
+        continue;
+      int64_t slack = 0;
+      // the analysis is for one core
+      if (partition->cores == 1)
+        CYCLESTAT_MEASURE(slack_site,
+                          slack = partition->slack_table_size > 0
+                                      ? table_slack(partition, current_time_us)
+                                      : online_slack(partition,
+                                                     current_time_us));
+      job->remaining = slack < SLACK_MAX_US ? slack : SLACK_MAX_US;
+      heap_remove(&partition->ready_queue, slot);
+      if (job->remaining > 0)
+        heap_push(&partition->ready_queue, slot);
+    }
+  }
+}
+
+/* Pick up tasks that joined or left the partition since the last pass.
+ * A new task is first released 'release_time' after it joined. A bandwidth
+ * server starts with a full budget and is released by aperiodic jobs. */
+static void apply_task_changes(EDFPartition *partition,
+                               int64_t current_time_us) {
+  EDFJob *jobs = partition->jobs;
+  bool any_change = false;
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    uint32_t changed = slot_set_take(partition->changed_slots, word);
+    any_change |= changed != 0;
+    while (changed != 0) {
+      TaskId slot = word * 32 + __builtin_ctz(changed);
+      changed &= changed - 1;
+      PeriodicTaskParams *task = partition->params[slot];
+      bool joined = task->handle != NULL && task->partition == partition->id;
+      // a slot may have been freed and taken again in the meantime
+      if (jobs[slot].params != NULL && (jobs[slot].params != task || !joined))
+        unschedule_slot(partition, slot);
+      if (jobs[slot].params == NULL && joined &&
+          IS_BANDWIDTH_SERVER(task->type)) {
+        jobs[slot] = (EDFJob){.params = task,
+                              .absolute_deadline = current_time_us,
+                              .remaining = MS_TO_US(task->execution_time)};
+        partition->server_slots[word] |= 1UL << (slot % 32);
+      } else if (jobs[slot].params == NULL && joined) {
+        jobs[slot] = (EDFJob){
+            .params = task,
+            .next_release = current_time_us + MS_TO_US(task->release_time)};
+        heap_push(&partition->release_calendar, slot);
       }
     }
+  }
+  if (any_change && use_schedule_tables)
+    table_attach(partition, current_time_us);
+  if (any_change && slack_computation == SLACK_TABLE)
+    slack_table_build(partition, current_time_us);
+}
+
+/* Release all jobs that are due. Release times are nominal, so a late
+ * wakeup does not shift later releases. The next release is scheduled with
+ * the period the task has at this release. */
+static void release_jobs(EDFPartition *partition, int64_t current_time_us) {
+  JobHeap *calendar = &partition->release_calendar;
+  while (calendar->size > 0 &&
+         partition->jobs[calendar->heap[0]].next_release <= current_time_us) {
+    TaskId slot = calendar->heap[0];
+    EDFJob *job = &partition->jobs[slot];
+    // the task left, but the change is not applied yet
+    if (job->params->handle == NULL) {
+      unschedule_slot(partition, slot);
+      continue;
+    }
+    if (job->params->type == SPORADIC_SERVER) {
+      sporadic_replenish(partition, slot, current_time_us);
+      continue;
+    }
+    BINLOG(" Release Task %d\n", job->params->id);
+    if (job->pending) {
+      printf("OVERRUN DETECTED: Task %d did not complete its job!\n",
+             job->params->id);
+      abort();
+    }
+    job->absolute_deadline =
+        job->next_release + MS_TO_US(job->params->deadline);
+    job->remaining = MS_TO_US(job->params->execution_time);
+    job->pending = true;
+    job->notified = true;
+    job->next_release += MS_TO_US(job->params->period);
+    heap_sift_down(calendar, 0);
+    heap_push(&partition->ready_queue, slot);
+    partition->released_slots[slot / 32] |= 1UL << (slot % 32);
+  }
+}
+
+/* Set the deadline and budget of a bandwidth server that is released at
+ * 'current_time_us' for the queued jobs. Returns false if the server has
+ * to wait for budget. */
+static bool server_release(EDFJob *job, const AperiodicJob *oldest,
+                           int64_t current_time_us) {
+  PeriodicTaskParams *task = job->params;
+  // runs ahead of the periodic jobs, its budget is set by steal_slack
+  if (task->type == SLACK_STEALER) {
+    job->absolute_deadline = current_time_us;
+    return true;
+  }
+  if (task->execution_time == 0)
+    return false;
+  switch (task->type) {
+  case SPORADIC_SERVER:
+    if (job->remaining < MS_TO_US(oldest->execution_time))
+      return false;
+    job->activation_time = current_time_us;
+    job->activation_budget = job->remaining;
+    job->absolute_deadline = current_time_us + MS_TO_US(task->period);
+    return true;
+  case TOTAL_BANDWIDTH_SERVER: {
+    // d_k = max(r_k, d_k-1) + C_k / U_s
+    int64_t arrival = oldest->arrival_time - start_time_us;
+    if (arrival < job->absolute_deadline)
+      arrival = job->absolute_deadline;
+    job->remaining = MS_TO_US(oldest->execution_time);
+    job->absolute_deadline =
+        arrival + job->remaining * task->period / task->execution_time;
+    return true;
+  }
+  case CONSTANT_BANDWIDTH_SERVER:
+    // keep the deadline only if the budget left does not exceed U_s until
+    // then, i.e., c_s < (d_s - r) * U_s
+    if (job->remaining * (int64_t)task->period >=
+        (job->absolute_deadline - current_time_us) *
+            (int64_t)task->execution_time) {
+      job->absolute_deadline = current_time_us + MS_TO_US(task->period);
+      job->remaining = MS_TO_US(task->execution_time);
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* Release the bandwidth servers that are idle while aperiodic jobs are
+ * queued. All servers share the queue, so a task set should have one. */
+static void activate_servers(EDFPartition *partition,
+                             int64_t current_time_us) {
+  AperiodicJob oldest;
+  if (!aperiodic_peek(&oldest))
+    return;
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    uint32_t servers = partition->server_slots[word];
+    while (servers != 0) {
+      TaskId slot = word * 32 + __builtin_ctz(servers);
+      servers &= servers - 1;
+      EDFJob *job = &partition->jobs[slot];
+      if (job->notified || job->params->handle == NULL ||
+          !server_release(job, &oldest, current_time_us))
+        continue;
+      BINLOG(" Release Task %d\n", job->params->id);
+      job->pending = true;
+      job->notified = true;
+      heap_push(&partition->ready_queue, slot);
+      partition->released_slots[slot / 32] |= 1UL << (slot % 32);
+    }
+  }
+}
+
+/* Notify the tasks released in this pass. This happens after their
+ * budgets are published: a global job may start on another core right
+ * away, before the scheduler is done. */
+static void notify_released(EDFPartition *partition) {
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    uint32_t released = partition->released_slots[word];
+    partition->released_slots[word] = 0;
+    while (released != 0) {
+      TaskId slot = word * 32 + __builtin_ctz(released);
+      released &= released - 1;
+      CYCLESTAT_MEASURE(notify_site,
+                        xTaskNotifyGive(partition->jobs[slot].params->handle));
+    }
+  }
+}
+
+/* Charge a running job for the time since it was dispatched. A server
+ * ends its job when the budget is used up, a constant bandwidth server
+ * recharges it and postpones its deadline instead, and a slack stealer
+ * keeps its job until it gets slack again; a task that exceeds its
+ * execution time keeps running at its deadline, and misses its next release
+ * if it does not complete in time. */
+static void account_running_job(EDFPartition *partition, unsigned int core,
+                                int64_t current_time_us) {
+  TaskId slot = partition->running_slots[core];
+  if (slot >= NUMBER_OF_TASKS || !partition->jobs[slot].pending)
+    return;
+  EDFJob *job = &partition->jobs[slot];
+  bool had_budget = job->remaining > 0;
+  job->remaining -= current_time_us - partition->dispatch_time_us;
+  if (!had_budget || job->remaining > 0)
+    return;
+  BINLOG(" Budget exhausted: Task %d\n", job->params->id);
+  if (job->params->type == CONSTANT_BANDWIDTH_SERVER) {
+    while (job->remaining <= 0 && job->params->execution_time > 0) {
+      job->remaining += MS_TO_US(job->params->execution_time);
+      job->absolute_deadline += MS_TO_US(job->params->period);
+    }
+    heap_sift_down(&partition->ready_queue,
+                   partition->ready_queue.position[slot]);
+  } else if (IS_SERVER(job->params->type) &&
+             job->params->type != SLACK_STEALER) {
+    // the server may finish its aperiodic task in the background
+    end_job(partition, slot);
+    CYCLESTAT_MEASURE(priority_site, vTaskPrioritySet(job->params->handle,
+                                                      taskIDLE_PRIORITY));
+    partition->running_slots[core] = NUMBER_OF_TASKS;
+  }
+}
+
+/* Publish when the budgets of the running jobs end. Between two passes
+ * this time does not change, so a reader never sees a stale budget. */
+static void publish_budgets(EDFPartition *partition) {
+  portENTER_CRITICAL(&budget_lock);
+  for (unsigned int core = 0; core < partition->cores; core++) {
+    TaskId slot = partition->running_slots[core];
+    bool running = slot < NUMBER_OF_TASKS && partition->jobs[slot].pending;
+    partition->budget_owners[core] =
+        running ? partition->jobs[slot].params : NULL;
+    partition->budget_ends_us[core] =
+        running ? partition->dispatch_time_us + partition->jobs[slot].remaining
+                : 0;
+  }
+  portEXIT_CRITICAL(&budget_lock);
+}
+
+int64_t edf_remaining_budget(PeriodicTaskParams *params) {
+  int64_t remaining = 0;
+  if (params->partition >= number_of_partitions)
+    return 0;
+  EDFPartition *partition = &partitions[params->partition];
+  int64_t current_time_us = esp_timer_get_time() - start_time_us;
+  portENTER_CRITICAL(&budget_lock);
+  for (unsigned int core = 0; core < partition->cores; core++) {
+    if (partition->budget_owners[core] == params)
+      remaining = partition->budget_ends_us[core] - current_time_us;
+  }
+  portEXIT_CRITICAL(&budget_lock);
+  return remaining > 0 ? remaining : 0;
+}
+
+/* Determine the jobs of 'partition' to execute under EDF, i.e., the
+ * 'cores' earliest deadlines of its ready queue, and hand the running
+ * priority over to them. Only preempted and newly selected tasks change
+ * their priority, preempted ones first. All times are absolute. */
+EDFInfo edf_select_next_job(unsigned int partition_id,
+                            int64_t current_time_us) {
+  EDFPartition *partition = &partitions[partition_id];
+  EDFJob *jobs = partition->jobs;
+  EDFInfo next_job = {NUMBER_OF_TASKS, INT64_MAX, INT64_MAX, false};
+  TaskId selected[EDF_CORES];
+  unsigned int count = 0;
+  if (partition->release_calendar.size > 0)
+    next_job.next_scheduler_wakeup =
+        jobs[partition->release_calendar.heap[0]].next_release;
+
+  // take the earliest deadlines off the heap and put them back
+  while (count < partition->cores && partition->ready_queue.size > 0) {
+    selected[count] = partition->ready_queue.heap[0];
+    heap_remove(&partition->ready_queue, selected[count++]);
+  }
+  for (unsigned int i = 0; i < count; i++)
+    heap_push(&partition->ready_queue, selected[i]);
+
+  for (unsigned int core = 0; core < partition->cores; core++) {
+    TaskId running_slot = partition->running_slots[core];
+    unsigned int i = 0;
+    while (i < count && selected[i] != running_slot)
+      i++;
+    if (running_slot >= NUMBER_OF_TASKS || i < count)
+      continue;
+    if (jobs[running_slot].params->handle != NULL)
+      CYCLESTAT_MEASURE(priority_site,
+                        vTaskPrioritySet(jobs[running_slot].params->handle,
+                                         taskIDLE_PRIORITY));
+    partition->running_slots[core] = NUMBER_OF_TASKS;
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    TaskId slot = selected[i];
+    if (running_index(partition, slot) < partition->cores)
+      continue;
+    CYCLESTAT_MEASURE(priority_site, vTaskPrioritySet(jobs[slot].params->handle,
+                                                      taskRUNNING_PRIORITY));
+    partition->running_slots[running_index(partition, NUMBER_OF_TASKS)] = slot;
+  }
+
+  if (count == 0)
+    return next_job;
+  next_job.next_task_id = selected[0];
+  next_job.earliest_deadline = jobs[selected[0]].absolute_deadline;
+  // wake up when a budget is used up, unless it already is
+  for (unsigned int i = 0; i < count; i++) {
+    TaskId slot = selected[i];
+    if (jobs[slot].remaining > 0 &&
+        current_time_us + jobs[slot].remaining <=
+            next_job.next_scheduler_wakeup) {
+      next_job.next_scheduler_wakeup = current_time_us + jobs[slot].remaining;
+      next_job.run_to_completion = true;
+    }
+  }
+  return next_job;
+}
+
+static void table_advance(EDFPartition *partition) {
+  const ScheduleTable *table = partition->table;
+  if (++partition->table_entry == table->number_of_entries) {
+    partition->table_entry = table->cycle_entry;
+    partition->table_base_us += MS_TO_US(table->hyperperiod_ms);
+  }
+  partition->frame_end_us = table_frame_end(partition);
+}
+
+/* Replaces edf_select_next_job while the partition follows a static
+ * schedule: the frame that covers 'current_time_us' runs its task if that
+ * has a pending job. Frames start and end at fixed times, which costs one
+ * step through the table per frame. A job that completes early leaves the
+ * rest of its frame idle, one that overruns its execution time only gets
+ * the processor in its own frames. */
+static EDFInfo table_select_next_job(EDFPartition *partition,
+                                     int64_t current_time_us) {
+  EDFJob *jobs = partition->jobs;
+  EDFInfo next_job = {NUMBER_OF_TASKS, INT64_MAX, INT64_MAX, false};
+
+  while (partition->frame_end_us <= current_time_us)
+    table_advance(partition);
+  uint8_t task = partition->table->entries[partition->table_entry].task;
+  TaskId slot =
+      task == SCHEDULE_IDLE ? NUMBER_OF_TASKS : partition->table_slots[task];
+  if (slot < NUMBER_OF_TASKS && !jobs[slot].pending)
+    slot = NUMBER_OF_TASKS;
+
+  TaskId running_slot = partition->running_slots[0];
+  if (running_slot != slot) {
+    if (running_slot < NUMBER_OF_TASKS &&
+        jobs[running_slot].params->handle != NULL)
+      CYCLESTAT_MEASURE(priority_site,
+                        vTaskPrioritySet(jobs[running_slot].params->handle,
+                                         taskIDLE_PRIORITY));
+    if (slot < NUMBER_OF_TASKS)
+      CYCLESTAT_MEASURE(priority_site,
+                        vTaskPrioritySet(jobs[slot].params->handle,
+                                         taskRUNNING_PRIORITY));
+    partition->running_slots[0] = slot;
+  }
+
+  // releases still wake the scheduler, so the tasks are notified on time
+  next_job.next_scheduler_wakeup = partition->frame_end_us;
+  if (partition->release_calendar.size > 0 &&
+      jobs[partition->release_calendar.heap[0]].next_release <
+          next_job.next_scheduler_wakeup)
+    next_job.next_scheduler_wakeup =
+        jobs[partition->release_calendar.heap[0]].next_release;
+  if (slot < NUMBER_OF_TASKS) {
+    next_job.next_task_id = slot;
+    next_job.earliest_deadline = jobs[slot].absolute_deadline;
+  }
+  return next_job;
+}
+
+/* Event driven EDF of one partition on a 64 bit microsecond timebase. The
+ * scheduler sleeps until a one-shot timer fires at the next release or
+ * budget exhaustion, a job completes (see edf_job_complete) or the task set
+ * changes. Jobs do not report their progress; the running job is charged the
+ * time between passes, the scheduler itself is not. */
+static void partition_scheduler(EDFPartition *partition) {
+  const esp_timer_create_args_t timer_args = {
+      .callback = event_timer_callback,
+      .arg = partition,
+      .name = "edf",
+  };
+  PeriodicTaskParams **params = partition->params;
+  partition->scheduler_handle = xTaskGetCurrentTaskHandle();
+  if (esp_timer_create(&timer_args, &partition->event_timer) != ESP_OK) {
+    printf("ERROR: Could not create the EDF timer of partition %u\n",
+           partition->id);
+    abort();
+  }
+
+  partition->dispatch_time_us = 0;
+  TaskId dispatched_slot = NUMBER_OF_TASKS;
+  while (true) {
+    CYCLESTAT_BEGIN(pass_span);
+    int64_t current_time_us = esp_timer_get_time() - start_time_us;
+
+    for (unsigned int core = 0; core < partition->cores; core++)
+      account_running_job(partition, core, current_time_us);
+    apply_completions(partition);
+    apply_task_changes(partition, current_time_us);
+    release_jobs(partition, current_time_us);
+    activate_servers(partition, current_time_us);
+    steal_slack(partition, current_time_us);
 
     // Schedule job with the earliest deadline
-    EDFInfo info = edf_select_next_job(params, current_time_sec);
-    if (info.next_task_id < NUMBER_OF_TASKS) {
-      vTaskPrioritySet(params[info.next_task_id]->handle, taskRUNNING_PRIORITY);
-      printf(" Schedule %d: for %lu seconds\n", params[info.next_task_id]->id,
-             info.next_scheduler_wakeup);
-
-      // "Hacky" solution to synchronize EDF and the tasks. Otherwise, the
-      // EDF scheduler typically wakes up before the tasks finishing time
-      // and would have to terminate the unfinished task...
-      for (TickType_t i = 0; i < info.next_scheduler_wakeup; i++) {
-        ulTaskNotifyTake(false, portMAX_DELAY);
-      }
-      current_time_sec += info.next_scheduler_wakeup;
-    } else {
-      vTaskDelay(TICKS_PER_SECOND);
-      current_time_sec++;
+    EDFInfo info;
+    CYCLESTAT_MEASURE(select_site,
+                      info = partition->table != NULL
+                                 ? table_select_next_job(partition,
+                                                         current_time_us)
+                                 : edf_select_next_job(partition->id,
+                                                       current_time_us));
+    if (info.next_task_id != dispatched_slot &&
+        info.next_task_id < NUMBER_OF_TASKS)
+      BINLOG("Time %" PRIu32 " ms: Core %u: Schedule %d\n",
+             (uint32_t)(current_time_us / 1000), partition->id,
+             params[info.next_task_id]->id);
+    dispatched_slot = info.next_task_id;
+
+    esp_timer_stop(partition->event_timer);
+    partition->dispatch_time_us = esp_timer_get_time() - start_time_us;
+    publish_budgets(partition);
+    notify_released(partition);
+    if (info.next_scheduler_wakeup != INT64_MAX) {
+      int64_t timeout_us =
+          info.next_scheduler_wakeup - partition->dispatch_time_us;
+      esp_timer_start_once(partition->event_timer,
+                           timeout_us > 0 ? timeout_us : 0);
+    }
+    CYCLESTAT_END(pass_site, pass_span);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+}
+
+static void partition_scheduler_task(void *v_partition) {
+  partition_scheduler((EDFPartition *)v_partition);
+}
+
+void edf_scheduler(PeriodicTaskParams **params) {
+  vTaskPrioritySet(NULL, schedulerPRIORITY);
+  start_time_us = esp_timer_get_time();
+  for (unsigned int i = 0; i < number_of_partitions; i++)
+    partitions[i].params = params;
+  // the calling task runs on core 0, see CONFIG_ESP_MAIN_TASK_AFFINITY
+  for (unsigned int i = 1; i < number_of_partitions; i++) {
+    if (xTaskCreatePinnedToCore(partition_scheduler_task, "edf",
+                                EDF_SCHEDULER_STACK_SIZE, &partitions[i],
+                                schedulerPRIORITY, NULL, i) != pdPASS) {
+      printf("ERROR: Could not create the EDF scheduler of partition %u\n", i);
+      abort();
     }
   }
+  partition_scheduler(&partitions[0]);
+}
+
+static bool partition_setup(EDFPartition *partition, unsigned int id,
+                            unsigned int cores, unsigned int number_of_tasks) {
+  *partition = (EDFPartition){.id = id, .cores = cores};
+  for (unsigned int core = 0; core < cores; core++)
+    partition->running_slots[core] = number_of_tasks;
+  partition->jobs = pvPortMalloc(number_of_tasks * sizeof(EDFJob));
+  partition->changed_slots = pvPortMalloc(slot_set_words() * sizeof(uint32_t));
+  partition->completed_slots =
+      pvPortMalloc(slot_set_words() * sizeof(uint32_t));
+  partition->server_slots = pvPortMalloc(slot_set_words() * sizeof(uint32_t));
+  partition->released_slots =
+      pvPortMalloc(slot_set_words() * sizeof(uint32_t));
+  partition->table_slots = pvPortMalloc(number_of_tasks * sizeof(TaskId));
+  partition->slack_tasks = pvPortMalloc(number_of_tasks * sizeof(SlackTask));
+  if (slack_computation == SLACK_TABLE)
+    partition->slack_table =
+        pvPortMalloc(SLACK_TABLE_MAX_ENTRIES * sizeof(SlackTableEntry));
+  if (partition->jobs == NULL || partition->changed_slots == NULL ||
+      partition->completed_slots == NULL || partition->server_slots == NULL ||
+      partition->released_slots == NULL || partition->table_slots == NULL ||
+      partition->slack_tasks == NULL ||
+      (slack_computation == SLACK_TABLE && partition->slack_table == NULL) ||
+      !heap_init(&partition->ready_queue, partition->jobs, number_of_tasks,
+                 true) ||
+      !heap_init(&partition->release_calendar, partition->jobs,
+                 number_of_tasks, false))
+    return false;
+  for (TaskId i = 0; i < number_of_tasks; i++)
+    partition->jobs[i] = (EDFJob){.params = NULL};
+  for (unsigned int word = 0; word < slot_set_words(); word++) {
+    partition->changed_slots[word] = 0;
+    partition->completed_slots[word] = 0;
+    partition->server_slots[word] = 0;
+    partition->released_slots[word] = 0;
+  }
+  return true;
 }
 
-void edf_setup(unsigned int number_of_tasks) {
+void edf_setup(unsigned int number_of_tasks, EDFMode edf_mode,
+               bool schedule_tables, SlackComputation slack) {
   NUMBER_OF_TASKS = number_of_tasks;
+  mode = edf_mode;
+  slack_computation = slack;
+  use_schedule_tables = schedule_tables && mode == EDF_PARTITIONED;
+  number_of_partitions = mode == EDF_GLOBAL ? 1 : EDF_PARTITIONS;
+  for (unsigned int i = 0; i < number_of_partitions; i++) {
+    if (!partition_setup(&partitions[i], i,
+                         mode == EDF_GLOBAL ? EDF_CORES : 1,
+                         number_of_tasks)) {
+      printf("ERROR: Could not allocate the EDF scheduler state\n");
+      abort();
+    }
+  }
 }
+
+EDFMode edf_mode() { return mode; }
@@ -11,27 +11,122 @@ typedef unsigned int TaskId;
 #define taskRUNNING_PRIORITY tskIDLE_PRIORITY + 1
 #define schedulerPRIORITY tskIDLE_PRIORITY + 2
 
+#define EDF_CORES portNUM_PROCESSORS
+// at most one partition per core
+#define EDF_PARTITIONS EDF_CORES
+
+/* EDF_PARTITIONED: every core runs its own EDF scheduler for the tasks
+ * admitted to its partition (PeriodicTaskParams.partition), which are pinned
+ * to that core. Tasks never migrate, so each partition is a uniprocessor
+ * EDF system with its own density test, see partition.h.
+ * EDF_GLOBAL: a single scheduler and ready queue for all tasks, which are
+ * not pinned. The EDF_CORES jobs with the earliest deadlines get the running
+ * priority, so FreeRTOS runs them on all cores and jobs migrate. All tasks
+ * are in partition 0, the admission uses the tests of global.h. */
+typedef enum { EDF_PARTITIONED, EDF_GLOBAL } EDFMode;
+
+/* How a SLACK_STEALER finds the slack of its partition at time t, i.e., the
+ * execution time it may take right away without a periodic job missing its
+ * deadline: the least (d - t) - demand(t, d) over the deadlines d of the
+ * periodic jobs, where the demand counts the remaining budget of the pending
+ * jobs and the WCET of the later jobs with deadlines up to d.
+ * SLACK_ONLINE steps through the deadlines from t on until a lower bound of
+ * all later ones is no smaller than the least slack so far, i.e., about one
+ * busy period of the partition, and takes the bound after
+ * SLACK_ONLINE_MAX_DEADLINES of them.
+ * SLACK_TABLE precomputes the demand of a hyperperiod whenever the tasks of
+ * the partition change, so a query costs one binary search per task. It
+ * bounds the slack from below and may find less than the on-line
+ * computation. Partitions with more than SLACK_TABLE_MAX_ENTRIES deadlines
+ * per hyperperiod compute on-line.
+ * Only under partitioned EDF; under global EDF the stealer gets no slack and
+ * runs in the background. Other servers of the partition are not counted. */
+typedef enum { SLACK_ONLINE, SLACK_TABLE } SlackComputation;
+
 static unsigned int NUMBER_OF_TASKS;
 
 typedef struct {
   bool accepted;
   double system_density;
+  TickType_t busy_period;  // synchronous busy period (processor demand test)
+  unsigned int iterations; // QPA iterations (processor demand test)
 } AcceptanceTestResult;
-static const AcceptanceTestResult default_result = {false, 0};
+static const AcceptanceTestResult default_result = {false, 0, 0, 0};
 
+/* Exact system density as the fraction 'numerator / lcm', where lcm is a
+ * common multiple of min(D, T) of all tasks that were added. */
 typedef struct {
-  TaskId next_task_id;
-  TickType_t earliest_deadline;
-  TickType_t next_scheduler_wakeup;
-  bool run_to_completion;
+  uint64_t numerator;
+  uint64_t lcm;
+} Density;
+static const Density empty_density = {0, 1};
+
+// times are absolute, in microseconds since the start of the scheduler
+typedef struct {
+  TaskId next_task_id; // of the earliest deadline
+  int64_t earliest_deadline;
+  int64_t next_scheduler_wakeup; // next release or budget exhaustion
+  bool run_to_completion;        // the budget ends before the next release
 } EDFInfo;
 
 void system_density_test(PeriodicTaskParams **params, TaskId task_id,
                          AcceptanceTestResult *results);
+void system_density_test_int(PeriodicTaskParams **params, TaskId task_id,
+                             AcceptanceTestResult *results);
+
+/* Exact EDF test based on the processor demand criterion, using the Quick
+ * Processor-demand Analysis (QPA) of Zhang & Burns. Same interface as
+ * system_density_test, but it also accepts constrained deadline sets whose
+ * density exceeds 1. A periodic server is modeled as a deferrable server,
+ * i.e., a periodic task with release jitter T_s - C_s. A sporadic or
+ * constant bandwidth server demands no more than a periodic task with
+ * D_s = T_s, a total bandwidth server no more than U_s * t. Also reports
+ * the synchronous busy period and the number of QPA iterations. */
+void processor_demand_test(PeriodicTaskParams **params, TaskId task_id,
+                           AcceptanceTestResult *results);
+
+/* Density bookkeeping in O(1). density_add returns false (and leaves the
+ * density unchanged) if the fraction would overflow. The density term of a
+ * bandwidth server is its reserved bandwidth C_s / T_s. */
+TickType_t density_denominator(PeriodicTaskParams *params);
+bool density_add(Density *density, TickType_t execution_time,
+                 TickType_t denominator);
+void density_subtract(Density *density, TickType_t execution_time,
+                      TickType_t denominator);
 
-EDFInfo edf_select_next_job(PeriodicTaskParams **params,
-                            TickType_t current_time_sec);
+/* Tell the scheduler of 'partition' that slot 'slot' of its task table got
+ * a new task or was freed. Entries of the table are only looked at again
+ * after this call, so a scheduling decision costs O(log n) instead of a scan
+ * of all tasks. A task that leaves is reported to its own partition, a task
+ * that joins to the partition it was admitted to. */
+void edf_task_changed(unsigned int partition, TaskId slot);
+
+/* Tell the scheduler of 'partition' that the job of slot 'slot' is
+ * complete. This is the only report a job makes, its execution time is
+ * accounted by the scheduler. */
+void edf_job_complete(unsigned int partition, TaskId slot);
+
+/* Wake up the schedulers from an ISR that queued an aperiodic job, so an
+ * idle bandwidth server is released right away. */
+void edf_aperiodic_arrival_from_isr();
+
+/* Budget left in microseconds if 'params' is the running job of its
+ * partition, else 0. Only to be called from the core of the partition. */
+int64_t edf_remaining_budget(PeriodicTaskParams *params);
+
+EDFInfo edf_select_next_job(unsigned int partition, int64_t current_time_us);
+
+/* Run the EDF schedulers of all partitions on the task table 'params'. The
+ * calling task becomes the scheduler of partition 0 and does not return,
+ * the other partitions get a scheduler task pinned to their core. */
 void edf_scheduler(PeriodicTaskParams **params);
-void edf_setup(unsigned int number_of_tasks);
+
+/* With 'schedule_tables', a partition whose tasks match a static schedule
+ * of schedule_table.h dispatches from it in O(1) per frame instead of
+ * edf_select_next_job, until its tasks change. Only partitioned EDF.
+ * 'slack' is the computation of the slack stealers. */
+void edf_setup(unsigned int number_of_tasks, EDFMode mode,
+               bool schedule_tables, SlackComputation slack);
+EDFMode edf_mode();
 
 #endif
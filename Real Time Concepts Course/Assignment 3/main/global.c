@@ -0,0 +1,163 @@
+#include "global.h"
+
+// margin of the floating point comparison of bak_test
+#define BAK_EPSILON 1e-9
+
+static bool included(AcceptanceTestResult *results, TaskId task_id, TaskId i) {
+  return i == task_id || results[i].accepted;
+}
+
+// deadline the tests use, at most the period, see global.h
+static uint64_t global_deadline(PeriodicTaskParams *params) {
+  int64_t deadline = params->deadline;
+  if (params->type == PERIODIC_SERVER)
+    deadline -= (int64_t)(params->period - params->execution_time);
+  if (IS_BANDWIDTH_SERVER(params->type) || deadline > (int64_t)params->period)
+    deadline = params->period;
+  return deadline > 0 ? deadline : 0;
+}
+
+/* Set up the result of params[task_id]. Returns false if some task cannot
+ * be analysed, which rejects the set. */
+static bool analysis_start(PeriodicTaskParams **params, TaskId task_id,
+                           AcceptanceTestResult *results) {
+  bool analysable = true;
+  double system_density = 0;
+  for (TaskId i = 0; i <= task_id; i++) {
+    if (!included(results, task_id, i))
+      continue;
+    uint64_t deadline = global_deadline(params[i]);
+    if (params[i]->type == TOTAL_BANDWIDTH_SERVER || deadline == 0 ||
+        deadline < params[i]->execution_time) {
+      analysable = false;
+      continue;
+    }
+    // conversion is only needed for reporting
+    system_density += params[i]->execution_time / (double)deadline;
+  }
+  results[task_id].accepted = false;
+  results[task_id].system_density = system_density;
+  return analysable;
+}
+
+void gfb_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores) {
+  Density density = empty_density;
+  PeriodicTaskParams *densest = NULL;
+  uint64_t capacity;
+  bool exact = true;
+
+  if (!analysis_start(params, task_id, results))
+    return;
+  for (TaskId i = 0; i <= task_id && exact; i++) {
+    if (!included(results, task_id, i))
+      continue;
+    PeriodicTaskParams *task = params[i];
+    exact = density_add(&density, task->execution_time, global_deadline(task));
+    if (densest == NULL || (uint64_t)task->execution_time *
+                                   global_deadline(densest) >
+                               (uint64_t)densest->execution_time *
+                                   global_deadline(task))
+      densest = task;
+  }
+  // sum(delta) + (m - 1) * delta_max <= m
+  for (unsigned int core = 1; core < cores && exact; core++)
+    exact = density_add(&density, densest->execution_time,
+                        global_deadline(densest));
+  if (exact && !__builtin_mul_overflow(density.lcm, (uint64_t)cores,
+                                       &capacity)) {
+    results[task_id].accepted = density.numerator <= capacity;
+    return;
+  }
+
+  // every term rounded up in Q32 fixed point, like system_density_test_int
+  uint64_t sum = 0, max_term = 0, term;
+  for (TaskId i = 0; i <= task_id; i++) {
+    if (!included(results, task_id, i))
+      continue;
+    uint64_t deadline = global_deadline(params[i]);
+    term = ((uint64_t)params[i]->execution_time << 32) / deadline +
+           (((uint64_t)params[i]->execution_time << 32) % deadline != 0);
+    sum += term;
+    if (term > max_term)
+      max_term = term;
+  }
+  results[task_id].accepted =
+      !__builtin_mul_overflow(max_term, (uint64_t)(cores - 1), &term) &&
+      !__builtin_add_overflow(sum, term, &sum) &&
+      sum <= (uint64_t)cores << 32;
+}
+
+void bak_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores) {
+  if (!analysis_start(params, task_id, results))
+    return;
+  for (TaskId k = 0; k <= task_id; k++) {
+    if (!included(results, task_id, k))
+      continue;
+    double deadline_k = global_deadline(params[k]);
+    double lambda = params[k]->execution_time / deadline_k;
+    double load = 0;
+    for (TaskId i = 0; i <= task_id; i++) {
+      if (!included(results, task_id, i))
+        continue;
+      double execution_time = params[i]->execution_time;
+      double period = params[i]->period;
+      double utilization = execution_time / period;
+      double beta =
+          utilization *
+          (1 + (period - global_deadline(params[i])) / deadline_k);
+      if (lambda < utilization)
+        beta += (execution_time - lambda * period) / deadline_k;
+      load += beta < 1 ? beta : 1;
+    }
+    // rounding must not accept a set at the bound
+    if (load > cores * (1 - lambda) + lambda - BAK_EPSILON)
+      return;
+  }
+  results[task_id].accepted = true;
+}
+
+void bcl_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores) {
+  if (!analysis_start(params, task_id, results))
+    return;
+  for (TaskId k = 0; k <= task_id; k++) {
+    if (!included(results, task_id, k))
+      continue;
+    uint64_t deadline_k = global_deadline(params[k]);
+    uint64_t slack = deadline_k - params[k]->execution_time;
+    uint64_t interference = 0;
+    bool below_slack = false; // some 0 < W_i <= D_k - C_k
+    for (TaskId i = 0; i <= task_id; i++) {
+      if (i == k || !included(results, task_id, i))
+        continue;
+      uint64_t execution_time = params[i]->execution_time;
+      uint64_t period = params[i]->period;
+      uint64_t deadline_i = global_deadline(params[i]);
+      // jobs of i with their deadline in the window, plus a carry-in job
+      uint64_t jobs =
+          deadline_k >= deadline_i ? (deadline_k - deadline_i) / period + 1 : 0;
+      uint64_t workload = jobs * execution_time;
+      if (deadline_k > jobs * period)
+        workload += deadline_k - jobs * period < execution_time
+                        ? deadline_k - jobs * period
+                        : execution_time;
+      interference += workload < slack ? workload : slack;
+      below_slack |= workload > 0 && workload <= slack;
+    }
+    uint64_t capacity = cores * slack;
+    if (interference > capacity || (interference == capacity && !below_slack))
+      return;
+  }
+  results[task_id].accepted = true;
+}
+
+void global_edf_test(PeriodicTaskParams **params, TaskId task_id,
+                     AcceptanceTestResult *results, unsigned int cores) {
+  gfb_test(params, task_id, results, cores);
+  if (!results[task_id].accepted)
+    bcl_test(params, task_id, results, cores);
+  if (!results[task_id].accepted)
+    bak_test(params, task_id, results, cores);
+}
@@ -0,0 +1,41 @@
+#ifndef EDF_GLOBAL_H
+#define EDF_GLOBAL_H
+
+#include "edf.h"
+#include "tasks.h"
+
+/* Sufficient tests for global EDF on 'cores' identical cores, i.e., the
+ * 'cores' jobs with the earliest deadlines run and jobs migrate between the
+ * cores. Same interface as system_density_test: params[task_id] is checked
+ * together with all earlier tasks whose result is accepted, and the system
+ * density is reported. None of the tests dominates the others, so
+ * global_edf_test tries them in order of their cost.
+ * Servers are analysed like in processor_demand_test: a deferrable server
+ * as a task with a deadline shortened by its release jitter T_s - C_s, a
+ * sporadic or constant bandwidth server as a task with D_s = T_s. Jobs of a
+ * total bandwidth server have no minimum distance, so a set with one is
+ * rejected. Deadlines beyond the period are analysed as D = T. */
+
+/* Goossens, Funk & Baruah: sum(delta) <= m - (m - 1) * delta_max, computed
+ * as an exact fraction. Should the fraction overflow, every term is rounded
+ * up in Q32 fixed point instead. */
+void gfb_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores);
+
+/* Baker: for every task k, sum(min(1, beta_i)) <= m (1 - lambda_k) +
+ * lambda_k with lambda_k = C_k / D_k. Computed in floating point and
+ * rounded against acceptance. */
+void bak_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores);
+
+/* Bertogna, Cirinei & Lipari: for every task k, the interference of the
+ * other tasks in a window of D_k, each capped at D_k - C_k, is below
+ * m (D_k - C_k). Computed exactly in integers. */
+void bcl_test(PeriodicTaskParams **params, TaskId task_id,
+              AcceptanceTestResult *results, unsigned int cores);
+
+/* GFB, then BCL, then BAK; accepted if one of them accepts. */
+void global_edf_test(PeriodicTaskParams **params, TaskId task_id,
+                     AcceptanceTestResult *results, unsigned int cores);
+
+#endif
@@ -1,5 +1,9 @@
+#include "admission.h"
+#include "benchmark.h"
+#include "cyclestat.h"
 #include "display.h"
 #include "edf.h"
+#include "sensitivity.h"
 #include "tasks.h"
 #include <math.h>
 #include <stdio.h>
@@ -16,72 +20,127 @@
 
 #define NUMBER_OF_TASKS 4
 
+// compare the integer and floating point density test at startup
+#define RUN_DENSITY_BENCHMARK false
+// compare the cost of BINLOG and printf at startup
+#define RUN_LOG_BENCHMARK false
+// print the scheduler overhead if CYCLESTAT_ENABLED, see cyclestat.h
+#define CYCLESTAT_REPORT_INTERVAL_MS 10000
+/* server of the aperiodic jobs, see TaskType_t. Compare the response times
+ * the server logs for the same execution time and period. */
+#define APERIODIC_SERVER_TYPE PERIODIC_SERVER
+// how a SLACK_STEALER server finds the slack, see SlackComputation
+#define SLACK_COMPUTATION SLACK_TABLE
+/* EDF_PARTITIONED pins every task to a core with its own EDF scheduler,
+ * EDF_GLOBAL runs the earliest deadlines on both cores, see EDFMode. Global
+ * EDF admits sets that no partitioning can place, e.g., with a heavy task. */
+#define EDF_MODE EDF_PARTITIONED
+/* placement of the tasks onto the EDF partitions, one per core, see
+ * partition.h. First fit packs the cores, worst fit balances them. */
+#define PARTITION_HEURISTIC PARTITION_WORST_FIT
+/* load of the periodic tasks, see workload.h. The memory and cache kernels
+ * slow each other down when both cores run them. */
+#define LOAD_KERNEL WORKLOAD_CPU
+// execution times of the jobs, up to 80% of the execution time of the task
+#define LOAD_DISTRIBUTION WORKLOAD_UNIFORM
+/* dispatch partitions whose tasks match a static schedule of
+ * schedule_table.c from the table, see schedule_table.h. Regenerate the
+ * table with schedgen after changing the tasks below. */
+#define SCHEDULE_TABLES false
+
 PeriodicTaskParams task1_params = {
     .id = 1,
-    .execution_time = 2,
-    .period = 5,
-    .deadline = 5,
+    .execution_time = 2000,
+    .period = 5000,
+    .deadline = 5000,
     .gpio = mainTASK_TASK1_GPIO,
     .type = PERIODIC_TASK,
 };
 PeriodicTaskParams task2_params = {
     .id = 2,
-    .execution_time = 1,
-    .period = 3,
-    .deadline = 3,
+    .execution_time = 1000,
+    .period = 3000,
+    .deadline = 3000,
     .gpio = mainTASK_TASK2_GPIO,
     .type = PERIODIC_TASK,
 };
 PeriodicTaskParams task3_params = {
     .id = 3,
-    .execution_time = 2,
-    .period = 7,
-    .deadline = 7,
+    .execution_time = 2000,
+    .period = 7000,
+    .deadline = 7000,
     .gpio = mainTASK_TASK3_GPIO,
     .type = PERIODIC_TASK,
 };
 PeriodicTaskParams ps_params = {
     .id = 4,
-    .execution_time = 1,
-    .period = 7,
-    .deadline = 7,
+    .execution_time = 1000,
+    .period = 7000,
+    .deadline = 7000,
     .gpio = No_GPIO,
-    .type = PERIODIC_SERVER,
+    .type = APERIODIC_SERVER_TYPE,
 };
 
 /* No need to change anything here... */
 void app_main(void) {
-  task_setup();
+  task_setup(LOAD_KERNEL, LOAD_DISTRIBUTION);
+  binlog_start(tskIDLE_PRIORITY);
+  cyclestat_start(tskIDLE_PRIORITY, CYCLESTAT_REPORT_INTERVAL_MS);
   ssd1306_setup();
-  edf_setup(NUMBER_OF_TASKS);
+  admission_setup(PARTITION_HEURISTIC);
+  edf_setup(MAX_ADMITTED_TASKS, EDF_MODE, SCHEDULE_TABLES, SLACK_COMPUTATION);
 
   PeriodicTaskParams *task_set[NUMBER_OF_TASKS] = {&task1_params, &task2_params,
                                                    &task3_params, &ps_params};
   AcceptanceTestResult results[NUMBER_OF_TASKS];
 
-  // Run system density test for all tasks
-  for (TaskId i = 0; i < NUMBER_OF_TASKS; i++) {
-    results[i] = default_result;
-    system_density_test(task_set, i, results);
-  }
+  if (RUN_DENSITY_BENCHMARK)
+    density_benchmark(task_set, NUMBER_OF_TASKS, 100);
+  if (RUN_LOG_BENCHMARK)
+    log_benchmark(32);
 
-  // Create tasks and provide the edf scheduler with the task handles
+  // Admit the tasks by decreasing density, accepted tasks start right away
+  admission_add_set(task_set, NUMBER_OF_TASKS, results);
   for (TaskId i = 0; i < NUMBER_OF_TASKS; i++) {
-    if (!results[i].accepted)
-      continue;
+    printf("Task %d: partition %u, density %f, accepted %s\n", task_set[i]->id,
+           task_set[i]->partition, results[i].system_density,
+           results[i].accepted ? "true" : "false");
+    if (results[i].busy_period > 0)
+      printf("  QPA: busy period %lu, %u iterations\n",
+             results[i].busy_period, results[i].iterations);
+  }
 
-    if (task_set[i]->type == PERIODIC_TASK) {
-      char task_name[6];
-      snprintf(task_name, 6, "task%c", task_set[i]->id);
-      xTaskCreate((void *)periodic_task_implementation, task_name,
-                  configMINIMAL_STACK_SIZE + 256, task_set[i], tskIDLE_PRIORITY,
-                  &task_set[i]->handle);
-    } else if (task_set[i]->type == PERIODIC_SERVER) {
-      xTaskCreate((void *)periodic_server_implementation, "PS",
-                  configMINIMAL_STACK_SIZE + 256, task_set[i], tskIDLE_PRIORITY,
-                  &task_set[i]->handle);
+  /* headroom of the admitted tasks, every partition on its own. The analysis
+   * is for a single core, so it does not apply to global EDF. Every task
+   * gets a page on the display for a second before the scheduler starts
+   * and the aperiodic jobs take the display over. */
+  for (unsigned int partition = 0;
+       EDF_MODE == EDF_PARTITIONED && partition < EDF_PARTITIONS; partition++) {
+    PeriodicTaskParams *admitted_set[NUMBER_OF_TASKS];
+    SensitivityResult sensitivity[NUMBER_OF_TASKS];
+    unsigned int number_admitted = 0;
+    for (TaskId i = 0; i < NUMBER_OF_TASKS; i++) {
+      if (results[i].accepted && task_set[i]->partition == partition)
+        admitted_set[number_admitted++] = task_set[i];
+    }
+    double breakdown =
+        density_sensitivity(admitted_set, number_admitted, sensitivity);
+    for (TaskId i = 0; i < number_admitted; i++) {
+      printf("Task %d: max WCET %lu, min period %lu\n", admitted_set[i]->id,
+             sensitivity[i].max_execution_time, sensitivity[i].min_period);
+    }
+    printf("Core %u: breakdown utilization %f\n", partition, breakdown);
+    for (TaskId i = 0; i < number_admitted; i++) {
+      SensitivityInfo info = {admitted_set[i]->id,
+                              admitted_set[i]->execution_time,
+                              admitted_set[i]->period,
+                              sensitivity[i].max_execution_time,
+                              sensitivity[i].min_period,
+                              breakdown};
+      ssd1306_print_sensitivity(&info);
+      sleep(1);
     }
   }
 
-  edf_scheduler(task_set);
+  edf_scheduler(admission_task_set());
 }
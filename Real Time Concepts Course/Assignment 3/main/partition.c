@@ -0,0 +1,62 @@
+#include "partition.h"
+
+// a denser than b, compared exactly as C_a * d_b > C_b * d_a
+static bool denser(PeriodicTaskParams *a, PeriodicTaskParams *b) {
+  return (uint64_t)a->execution_time * density_denominator(b) >
+         (uint64_t)b->execution_time * density_denominator(a);
+}
+
+// insertion sort, task sets are small and often sorted already
+void partition_sort(PeriodicTaskParams **params, unsigned int number_of_tasks) {
+  for (unsigned int i = 1; i < number_of_tasks; i++) {
+    PeriodicTaskParams *task = params[i];
+    unsigned int j = i;
+    while (j > 0 && denser(task, params[j - 1])) {
+      params[j] = params[j - 1];
+      j--;
+    }
+    params[j] = task;
+  }
+}
+
+/* Run the density test of 'partition' for params[task_id]. The tasks of the
+ * partition are selected through the 'accepted' flags of the earlier
+ * results, so no copy of the partition is needed. */
+static void partition_test(PeriodicTaskParams **params, TaskId task_id,
+                           unsigned int partition,
+                           AcceptanceTestResult *results) {
+  for (TaskId i = 0; i < task_id; i++)
+    results[i].accepted = params[i]->partition == partition;
+  results[task_id] = default_result;
+  system_density_test_int(params, task_id, results);
+}
+
+bool partition_task_set(PeriodicTaskParams **params,
+                        unsigned int number_of_tasks, unsigned int partitions,
+                        PartitionHeuristic heuristic,
+                        AcceptanceTestResult *results) {
+  bool all_placed = true;
+  partition_sort(params, number_of_tasks);
+
+  for (TaskId i = 0; i < number_of_tasks; i++) {
+    AcceptanceTestResult best = default_result;
+    params[i]->partition = partitions;
+    for (unsigned int p = 0; p < partitions; p++) {
+      partition_test(params, i, p, results);
+      if (!results[i].accepted ||
+          (best.accepted &&
+           results[i].system_density >= best.system_density))
+        continue;
+      best = results[i];
+      params[i]->partition = p;
+      if (heuristic == PARTITION_FIRST_FIT)
+        break;
+    }
+    results[i] = best;
+    all_placed &= best.accepted;
+  }
+
+  for (TaskId i = 0; i < number_of_tasks; i++)
+    results[i].accepted = params[i]->partition < partitions;
+  return all_placed;
+}
@@ -0,0 +1,31 @@
+#ifndef EDF_PARTITION_H
+#define EDF_PARTITION_H
+
+#include "edf.h"
+#include "tasks.h"
+
+/* Bin packing of a task set onto the partitions of the EDF scheduler, see
+ * EDF_PARTITIONS. Every partition is a bin of capacity 1 in terms of system
+ * density. Placing the tasks in order of decreasing density ("decreasing")
+ * leaves the small tasks to fill the gaps. */
+typedef enum {
+  PARTITION_FIRST_FIT, // lowest partition that accepts the task
+  PARTITION_WORST_FIT, // accepting partition with the lowest density
+} PartitionHeuristic;
+
+/* Sort params[0..number_of_tasks-1] by decreasing density
+ * C / density_denominator, tasks of the same density keep their order. */
+void partition_sort(PeriodicTaskParams **params, unsigned int number_of_tasks);
+
+/* Offline first-fit or worst-fit decreasing partitioning onto 'partitions'
+ * partitions. Sorts 'params' with partition_sort and decides each task with
+ * system_density_test_int on the tasks already placed in a partition.
+ * results[i] and params[i]->partition describe the i-th task after sorting;
+ * a rejected task gets partition 'partitions'. Returns true if every task
+ * was placed. */
+bool partition_task_set(PeriodicTaskParams **params,
+                        unsigned int number_of_tasks, unsigned int partitions,
+                        PartitionHeuristic heuristic,
+                        AcceptanceTestResult *results);
+
+#endif
@@ -0,0 +1,39 @@
+/* Generated by schedgen (Host/schedgen): EDF, 2 partition(s), worst fit.
+ * Regenerate instead of editing, see schedule_table.h. */
+
+#include "schedule_table.h"
+
+// partition 0: EDF over 35000 ms
+static const ScheduleTask partition0_tasks[] = {
+    {.id = 1, .release_time = 0, .execution_time = 2000, .period = 5000,
+     .deadline = 5000, .type = PERIODIC_TASK},
+    {.id = 4, .release_time = 0, .execution_time = 1000, .period = 7000,
+     .deadline = 7000, .type = PERIODIC_SERVER},
+};
+static const ScheduleEntry partition0_entries[] = {
+    {0, 0}, {2000, 1}, {3000, SCHEDULE_IDLE}, {5000, 0},
+    {7000, 1}, {8000, SCHEDULE_IDLE}, {10000, 0}, {12000, SCHEDULE_IDLE},
+    {14000, 1}, {15000, 0}, {17000, SCHEDULE_IDLE}, {20000, 0},
+    {22000, 1}, {23000, SCHEDULE_IDLE}, {25000, 0}, {27000, SCHEDULE_IDLE},
+    {28000, 1}, {29000, SCHEDULE_IDLE}, {30000, 0}, {32000, SCHEDULE_IDLE},
+};
+
+// partition 1: EDF over 21000 ms
+static const ScheduleTask partition1_tasks[] = {
+    {.id = 2, .release_time = 0, .execution_time = 1000, .period = 3000,
+     .deadline = 3000, .type = PERIODIC_TASK},
+    {.id = 3, .release_time = 0, .execution_time = 2000, .period = 7000,
+     .deadline = 7000, .type = PERIODIC_TASK},
+};
+static const ScheduleEntry partition1_entries[] = {
+    {0, 0}, {1000, 1}, {3000, 0}, {4000, SCHEDULE_IDLE},
+    {6000, 0}, {7000, 1}, {9000, 0}, {10000, SCHEDULE_IDLE},
+    {12000, 0}, {13000, SCHEDULE_IDLE}, {14000, 1}, {15000, 0},
+    {16000, 1}, {17000, SCHEDULE_IDLE}, {18000, 0}, {19000, SCHEDULE_IDLE},
+};
+
+const ScheduleTable schedule_tables[] = {
+    {partition0_tasks, 2, partition0_entries, 20, 0, 0, 35000},
+    {partition1_tasks, 2, partition1_entries, 16, 0, 0, 21000},
+};
+const unsigned int number_of_schedule_tables = 2;
@@ -0,0 +1,47 @@
+#ifndef EDF_SCHEDULE_TABLE_H
+#define EDF_SCHEDULE_TABLE_H
+
+#include "tasks.h"
+
+/* Static schedules of fixed task sets, generated offline by schedgen (see
+ * Host/README.md) into schedule_table.c. A table holds the dispatch
+ * decisions of one partition over its hyperperiod, simulated with EDF or
+ * RM on the execution times of the tasks. While the tasks of a partition
+ * are exactly those of a table, and all of them joined in the same pass of
+ * the scheduler, the scheduler dispatches from the table instead of its
+ * ready queue, see edf_setup. */
+
+#define SCHEDULE_IDLE 0xFF
+
+// 'task' runs from 'start_ms' until the next entry starts
+typedef struct {
+  uint32_t start_ms; // since the tasks joined
+  uint8_t task;      // index into ScheduleTable.tasks, or SCHEDULE_IDLE
+} ScheduleEntry;
+
+// parameters of a task the table was generated for, in milliseconds
+typedef struct {
+  char id;
+  TickType_t release_time;
+  TickType_t execution_time;
+  TickType_t period;
+  TickType_t deadline;
+  TaskType_t type;
+} ScheduleTask;
+
+/* The entries before 'cycle_entry' run once. The entries from there on
+ * start at 'cycle_start_ms' and repeat every 'hyperperiod_ms'. */
+typedef struct {
+  const ScheduleTask *tasks;
+  unsigned int number_of_tasks;
+  const ScheduleEntry *entries;
+  unsigned int number_of_entries;
+  unsigned int cycle_entry;
+  uint32_t cycle_start_ms;
+  uint32_t hyperperiod_ms;
+} ScheduleTable;
+
+extern const ScheduleTable schedule_tables[];
+extern const unsigned int number_of_schedule_tables;
+
+#endif
@@ -0,0 +1,98 @@
+#include "sensitivity.h"
+
+// Density of the task set with the term of 'task' replaced by (C, d)
+static bool fits(Density total, PeriodicTaskParams *task,
+                 TickType_t execution_time, TickType_t denominator) {
+  density_subtract(&total, task->execution_time, density_denominator(task));
+  // an overflowing density is treated as infeasible
+  return density_add(&total, execution_time, denominator) &&
+         total.numerator <= total.lcm;
+}
+
+static TickType_t max_execution_time(Density total, PeriodicTaskParams *task) {
+  TickType_t denominator = density_denominator(task);
+  TickType_t low = task->execution_time, high = denominator;
+
+  // largest execution time in [low, high] with density <= 1
+  while (low < high) {
+    TickType_t mid = low + (high - low + 1) / 2;
+    if (fits(total, task, mid, denominator))
+      low = mid;
+    else
+      high = mid - 1;
+  }
+  return low;
+}
+
+static TickType_t min_period(Density total, PeriodicTaskParams *task) {
+  TickType_t low = task->execution_time > 0 ? task->execution_time : 1;
+  TickType_t high = task->period;
+
+  // smallest period in [low, high] with density <= 1
+  while (low < high) {
+    TickType_t mid = low + (high - low) / 2;
+    if (fits(total, task, task->execution_time,
+             task->deadline < mid ? task->deadline : mid))
+      high = mid;
+    else
+      low = mid + 1;
+  }
+  return high;
+}
+
+// Density with all WCETs scaled by the Q16 factor 'scale', rounded up
+static bool scaled_fits(PeriodicTaskParams **params,
+                        unsigned int number_of_tasks, uint64_t scale) {
+  Density total = empty_density;
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    uint64_t scaled = (uint64_t)params[i]->execution_time * scale;
+    scaled = (scaled >> 16) + ((scaled & 0xFFFF) != 0);
+    if (!density_add(&total, scaled, density_denominator(params[i])))
+      return false;
+  }
+  return total.numerator <= total.lcm;
+}
+
+double density_sensitivity(PeriodicTaskParams **params,
+                           unsigned int number_of_tasks,
+                           SensitivityResult *results) {
+  Density total = empty_density;
+  uint64_t low = 1 << 16, high = UINT32_MAX;
+  double utilization = 0;
+
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    if (!density_add(&total, params[i]->execution_time,
+                     density_denominator(params[i]))) {
+      printf("ERROR: Density of the task set cannot be represented\n");
+      return 0;
+    }
+    // beyond this factor, the density of task i alone exceeds 1
+    uint64_t limit = ((uint64_t)density_denominator(params[i]) + 1) << 16;
+    if (params[i]->execution_time > 0)
+      limit /= params[i]->execution_time;
+    if (limit < high)
+      high = limit;
+  }
+  if (total.numerator > total.lcm)
+    return 0;
+
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    results[i].max_execution_time = max_execution_time(total, params[i]);
+    results[i].min_period = min_period(total, params[i]);
+  }
+
+  // largest common scaling factor in [low, high]
+  while (low < high) {
+    uint64_t mid = low + (high - low + 1) / 2;
+    if (scaled_fits(params, number_of_tasks, mid))
+      low = mid;
+    else
+      high = mid - 1;
+  }
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    uint64_t scaled = (uint64_t)params[i]->execution_time * low;
+    scaled = (scaled >> 16) + ((scaled & 0xFFFF) != 0);
+    utilization += (double)scaled / params[i]->period;
+  }
+  return utilization;
+}
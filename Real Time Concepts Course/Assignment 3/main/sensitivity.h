@@ -0,0 +1,24 @@
+#ifndef EDF_SENSITIVITY_H
+#define EDF_SENSITIVITY_H
+
+#include "edf.h"
+#include "tasks.h"
+
+typedef struct {
+  TickType_t max_execution_time; // largest WCET that keeps the density <= 1
+  TickType_t min_period; // smallest period (deadline min(D, T)) that does
+} SensitivityResult;
+
+/* Sensitivity analysis of params[0..number_of_tasks-1] based on the system
+ * density test. All values are found by binary search; every probe only
+ * swaps the density term of one task (density_subtract / density_add), so it
+ * costs O(1) instead of a whole density test.
+ * - results: output array of size number_of_tasks
+ * Returns the breakdown utilization, i.e., the utilization once all WCETs
+ * are scaled up by the largest common factor that keeps the density <= 1,
+ * or 0 if the density of the task set already exceeds 1. */
+double density_sensitivity(PeriodicTaskParams **params,
+                           unsigned int number_of_tasks,
+                           SensitivityResult *results);
+
+#endif
@@ -1,6 +1,45 @@
 #include "tasks.h"
+#include "admission.h"
+#include "aperiodic.h"
 #include <unistd.h>
 
+static WorkloadKernel load_kernel;
+static WorkloadDistribution load_distribution;
+
+/* An aperiodic job executes like a periodic one, on the kernel of
+ * task_setup, so it uses up the budget of its server. The display server
+ * renders the frames it posts at its own priority. */
+static void run_aperiodic_job(const AperiodicJob *job) {
+  switch (job->type) {
+  case APERIODIC_SNOWMAN:
+    for (unsigned int frame = 0; frame < SNOWMAN_FRAMES; frame++) {
+      workload_run(load_kernel, workload_ms_to_cycles(SNOWMAN_FRAME_MS));
+      ssd1306_print_snowman_frame(frame);
+    }
+    break;
+  }
+  aperiodic_complete(job);
+}
+
+/* Whether the server runs the next queued job in its current job.
+ * 'served' jobs already ran since the server was released. */
+static bool server_admits(PeriodicTaskParams *params, const AperiodicJob *job,
+                          unsigned int served) {
+  switch (params->type) {
+  case TOTAL_BANDWIDTH_SERVER:
+    // the deadline and budget were derived from the oldest job only
+    return served == 0;
+  case CONSTANT_BANDWIDTH_SERVER:
+    // an exhausted budget postpones the deadline instead
+    return true;
+  case SLACK_STEALER:
+    // the scheduler hands out the slack while the job lasts
+    return true;
+  default:
+    return (int64_t)job->execution_time * 1000 <= edf_remaining_budget(params);
+  }
+}
+
 void periodic_server_implementation(void *v_params) {
   // cast needed as xTaskCreate expects void pointer in first arg
   PeriodicTaskParams *params = (PeriodicTaskParams *)v_params;
@@ -10,109 +49,94 @@ void periodic_server_implementation(void *v_params) {
     ulTaskNotifyTake(true, portMAX_DELAY);
 
     /* Subtask 2: Complete the periodic server
-     * An aperiodic task is released whenever the button is pressed.
-     * The number of ready aperiodic tasks is (for simplicity) stored
-     * in the counter 'aperiodic_tasks_available'. Moreover, each
-     * aperiodic task executes for one second (i.e., for the entire
-     * execution time of the periodic server).
-     *
-     * In detail, implement the following functionality:
-     *  - For each available aperiodic task, call
-     *    'ssd1306_print_aperiodic_task()' to trigger a animation on
-     *    the display. The duration of this animation is one second.
-     *  - Update 'aperiodic_tasks_available' after finishing an
-     *    aperiodic task.
-     *  - Notify the schedulerTask if either:
-     *    -> there are no remaining aperiodic tasks and the periodic
-     *       server yields its execution time, the periodic server
-     *       will still loose the budget
-     *    -> the periodic server completed an aperiodic task
-     *       (this is solely used for synchronization; otherwise, the
-     *       EDF scheduler may not continue)
-     *    To notify the schedulerTask, use
-     *    'vTaskNotifyGiveFromISR(schedulerTask, NULL)'
+     * An aperiodic job is requested whenever the button is pressed. The
+     * ISR queues it with its arrival time and WCET estimate, see
+     * aperiodic.h. The server runs the queued jobs in arrival order as
+     * long as the next one fits into its job, see server_admits.
+     * The EDF scheduler enforces the budget of the server. Completing
+     * the job below without an aperiodic job yields the budget, the
+     * periodic server will still loose it. The bandwidth servers are
+     * only released while jobs are queued, see TaskType_t.
      */
-
-    // default behavior: yield execution right back to the EDF scheduler
-    printf(" Button Pressed %ld Times\n", aperiodic_tasks_available);
-    vTaskNotifyGiveFromISR(schedulerTask, NULL);
-
-    if(aperiodic_tasks_available>0){
-      while(aperiodic_tasks_available>0){
-        ssd1306_print_aperiodic_task();
-        aperiodic_tasks_available--;
-        vTaskNotifyGiveFromISR(schedulerTask, NULL);
-      }
-    }
-    else{
-      vTaskNotifyGiveFromISR(schedulerTask, NULL);
+    AperiodicJob job;
+    unsigned int served = 0;
+    BINLOG(" Aperiodic jobs pending: %" PRIu32 "\n", aperiodic_pending());
+    while (aperiodic_peek(&job) && server_admits(params, &job, served)) {
+      aperiodic_pop();
+      run_aperiodic_job(&job);
+      served++;
     }
+
+    // leave the task set if the server was removed in the meantime
+    if (!admission_job_complete(params))
+      vTaskDelete(NULL);
   }
 }
 
 /* No need to change anything below this point... */
 
-void busy_waiting(TickType_t until) {
-  while (xTaskGetTickCount() < until) {
-  }
-}
-
-/* Useless load for 'duration' (in seconds) with busy waiting.
- * After each second, the schedulerTask is notified using
- * 'vTaskNotifyGiveFromISR'. This is essentially a counting
- * semaphore to synchronize the EDF scheduler and the tasks
- * (reducing the race-conditions and avoiding having to terminate
- * overrunning tasks). */
-void task_useless_load(PeriodicTaskParams *params, TickType_t duration) {
-  TickType_t i;
-  unsigned long j;
-
-  for (i = 0; i < duration; ++i) {
-    TickType_t time_unit_start = xTaskGetTickCount();
-    printf(" Execute: Task %d (%ld/%ld)\n", params->id,
-           params->elapsed_time + 1, params->execution_time);
-    // we use 800 instead of 1000 for a conservative WCET of 1 second
-    for (j = 0; j < 800 / BLINKING_SLEEP_MS; ++j) {
-      busy_waiting(time_unit_start +
-                   (2 * j + 1) * pdMS_TO_TICKS(BLINKING_SLEEP_MS));
-      gpio_set_level(params->gpio, 0);
-      busy_waiting(time_unit_start +
-                   2 * (j + 1) * pdMS_TO_TICKS(BLINKING_SLEEP_MS));
-      gpio_set_level(params->gpio, 1);
-    }
-    params->elapsed_time++;
-    vTaskNotifyGiveFromISR(schedulerTask, NULL);
+/* Useless load of at most 'duration' (in milliseconds) on the calibrated
+ * kernel of task_setup. Every job draws how long it runs from the
+ * distribution of task_setup, with 'seed' of its task. The kernel counts
+ * executed cycles, so preemption does not shorten the load. The task does
+ * not report its progress, the EDF scheduler accounts its execution time. */
+void task_useless_load(PeriodicTaskParams *params, TickType_t duration,
+                       uint32_t *seed) {
+  // we use 80% of the duration for a conservative WCET
+  uint64_t load_cycles = workload_sample(
+      load_distribution, workload_ms_to_cycles(duration) * 4 / 5, seed);
+  uint64_t blink_cycles = workload_ms_to_cycles(BLINKING_SLEEP_MS);
+  uint32_t level = 1;
+
+  BINLOG(" Execute: Task %d (%" PRIu32 " ms)\n", params->id,
+         (uint32_t)(load_cycles / workload_ms_to_cycles(1)));
+  while (load_cycles > 0) {
+    uint64_t cycles = load_cycles < blink_cycles ? load_cycles : blink_cycles;
+    workload_run(load_kernel, cycles);
+    load_cycles -= cycles;
+    level = !level;
+    gpio_set_level(params->gpio, level);
   }
 }
 
 void periodic_task_implementation(void *v_params) {
   // cast needed as xTaskCreate expects void pointer in first arg
   PeriodicTaskParams *params = (PeriodicTaskParams *)v_params;
+  // the same task runs the same sequence of execution times
+  uint32_t seed = params->id;
 
   // indicate that task is ready
   ulTaskNotifyTake(true, portMAX_DELAY);
   gpio_set_level(params->gpio, 1);
 
-  params->elapsed_time = 0;
   for (;;) {
-    task_useless_load(params, params->execution_time);
+    task_useless_load(params, params->execution_time, &seed);
     gpio_set_level(params->gpio, 0);
-    printf(" Complete: Task %d\n", params->id);
+    BINLOG(" Complete: Task %d\n", params->id);
 
-    params->elapsed_time = 0;
+    // leave the task set if the task was removed in the meantime
+    if (!admission_job_complete(params))
+      vTaskDelete(NULL);
     ulTaskNotifyTake(true, portMAX_DELAY);
     gpio_set_level(params->gpio, 1);
   }
 }
 
 /* Interrupt service routine after button press.
- * Bonus Task: Make it thread-safe. */
+ * Queues an aperiodic job without waiting, see aperiodic.h. */
 static void IRAM_ATTR gpio_isr_handler(void *arg) {
-  aperiodic_tasks_available++;
+  (void)arg; // the button is the only input
+  if (aperiodic_request(APERIODIC_SNOWMAN, APERIODIC_SNOWMAN_WCET_MS))
+    edf_aperiodic_arrival_from_isr();
 }
 
-// Register GPIO pins for LEDs and for the button
-void task_setup() {
+/* Register GPIO pins for LEDs and for the button, and calibrate the load
+ * of the periodic tasks. */
+void task_setup(WorkloadKernel kernel, WorkloadDistribution distribution) {
+  load_kernel = kernel;
+  load_distribution = distribution;
+  workload_calibrate();
+
   gpio_config_t io_conf_in = {.pin_bit_mask = GPIO_INPUT_PIN_SEL,
                               .mode = GPIO_MODE_INPUT,
                               .pull_up_en = 1,
@@ -120,8 +144,7 @@ void task_setup() {
                               .intr_type = GPIO_INTR_POSEDGE};
   gpio_config(&io_conf_in);
   gpio_install_isr_service(ESP_INTR_FLAG_DEFAULT);
-  gpio_isr_handler_add(GPIO_INPUT_BTN, gpio_isr_handler,
-                       (void *)GPIO_INPUT_BTN);
+  gpio_isr_handler_add(GPIO_INPUT_BTN, gpio_isr_handler, NULL);
 
   gpio_config_t io_conf_out = {.pin_bit_mask = GPIO_PIN_BIT_MASK,
                                .mode = GPIO_MODE_OUTPUT,
@@ -129,5 +152,4 @@ void task_setup() {
                                .pull_down_en = 0,
                                .intr_type = GPIO_INTR_DISABLE};
   gpio_config(&io_conf_out);
-  schedulerTask = xTaskGetCurrentTaskHandle();
 }
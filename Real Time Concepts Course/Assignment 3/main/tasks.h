@@ -3,18 +3,22 @@
 
 /* No need to change anything here... */
 
+#include "binlog.h"
 #include "display.h"
 #include "driver/gpio.h"
 #include "esp_chip_info.h"
 #include "esp_flash.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "sdkconfig.h"
+#include "workload.h"
 #include <inttypes.h>
 #include <stdio.h>
 
 #define TICKS_PER_SECOND pdMS_TO_TICKS(1000UL)
+// executed load between two toggles of the LED
 #define BLINKING_SLEEP_MS 100
 
 #define mainTASK_TASK1_GPIO GPIO_NUM_16
@@ -29,26 +33,53 @@
 #define GPIO_INPUT_BTN GPIO_NUM_15
 #define GPIO_INPUT_PIN_SEL 1ULL << GPIO_INPUT_BTN
 
-enum TaskType_t { PERIODIC_TASK, PERIODIC_SERVER };
+/* Servers run the aperiodic jobs of aperiodic.h in their budget.
+ * PERIODIC_SERVER is a deferrable server: its budget is replenished every
+ * period and kept until the end of the period.
+ * SPORADIC_SERVER starts with a full budget; budget it uses is given back
+ * one period after the server became active, which also is its deadline.
+ * TOTAL_BANDWIDTH_SERVER gives each job the deadline
+ * max(arrival, previous deadline) + WCET / U_s and a budget of its WCET.
+ * CONSTANT_BANDWIDTH_SERVER recharges an exhausted budget right away and
+ * postpones its deadline by a period instead.
+ * SLACK_STEALER runs ahead of all periodic jobs for as long as they have
+ * slack, see SlackComputation, and waits for slack otherwise.
+ * For all but the deferrable server, execution_time / period is the
+ * reserved bandwidth U_s and 'deadline' is ignored. A slack stealer needs
+ * no bandwidth of its own, so its execution time may be 0. */
+enum TaskType_t {
+  PERIODIC_TASK,
+  PERIODIC_SERVER,
+  SPORADIC_SERVER,
+  TOTAL_BANDWIDTH_SERVER,
+  CONSTANT_BANDWIDTH_SERVER,
+  SLACK_STEALER
+};
 typedef enum TaskType_t TaskType_t;
 
-static TaskHandle_t schedulerTask = NULL;
-static uint32_t aperiodic_tasks_available = 0;
+#define IS_SERVER(type) ((type) != PERIODIC_TASK)
+// released by aperiodic arrivals instead of periodically
+#define IS_BANDWIDTH_SERVER(type)                                              \
+  ((type) == SPORADIC_SERVER || (type) == TOTAL_BANDWIDTH_SERVER ||            \
+   (type) == CONSTANT_BANDWIDTH_SERVER || (type) == SLACK_STEALER)
 
+// times are in milliseconds
 typedef struct {
   char id;
+  TickType_t release_time; // phase of the first job after the task joined
   TickType_t execution_time;
   TickType_t period;
   TickType_t deadline;
   gpio_num_t gpio;
   TaskType_t type;
-  TickType_t elapsed_time;
   TaskHandle_t handle;
+  unsigned int partition; // core whose EDF scheduler runs the task
 } PeriodicTaskParams;
 
-void task_useless_load(PeriodicTaskParams *params, TickType_t duration);
+void task_useless_load(PeriodicTaskParams *params, TickType_t duration,
+                       uint32_t *seed);
 void periodic_task_implementation(void *v_params);
 void periodic_server_implementation(void *v_params);
-void task_setup();
+void task_setup(WorkloadKernel kernel, WorkloadDistribution distribution);
 
 #endif
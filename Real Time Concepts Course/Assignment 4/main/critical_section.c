@@ -30,6 +30,12 @@ static size_t task_profiles_size = 0;
 // Stores all ceilings in the system that are currently active
 static PriorityType_t active_system_ceilings[MAX_RESOURCE_COUNT] = {tskIDLE_PRIORITY};
 
+// Overhead of the protocol without the time spent blocked, see cyclestat.h
+CYCLESTAT_SITE(wait_site, "icpp_wait");
+CYCLESTAT_SITE(signal_site, "icpp_signal");
+CYCLESTAT_SITE(priority_site, "icpp_priority_set");
+CYCLESTAT_SITE(give_site, "icpp_unblock_give");
+
 // Find the task profile of the current task
 TaskProfile *getCurrentTaskProfile()
 {
@@ -103,9 +109,9 @@ void releaseAllCeilingBlocks()
   // Release all
   for (size_t i = 0; i < task_profiles_size; i++)
   {
-    xSemaphoreGive(task_profiles[i].task_semaphore);
+    CYCLESTAT_MEASURE(give_site, xSemaphoreGive(task_profiles[i].task_semaphore));
     if (ADDITIONAL_DEBUG_MESSAGES)
-      printf("Task %s ceiling-unblocked\n", task_profiles[i].task_params->id);
+      BINLOG("Task %s ceiling-unblocked\n", task_profiles[i].task_params->id);
   }
 }
 
@@ -168,29 +174,32 @@ CriticalSectionSemaphore usPrioritySemaphoreInit(void **params,
 void usPrioritySemaphoreWait(CriticalSectionSemaphore *cs_semaphore)
 {
   TaskProfile *current_task_profile = getCurrentTaskProfile();
+  CYCLESTAT_BEGIN(wait_span);
 
   while (true)
   {
     // Do regular blocking when resource not available
     xSemaphoreTake(cs_semaphore->semaphore, portMAX_DELAY);
+    // Measure from the last time the resource semaphore was taken
+    CYCLESTAT_RESTART(wait_span);
     // Check ceilings
     PriorityType_t system_ceiling = getMaxCeilingListValue(active_system_ceilings);
     // 1. Is my priority higher than the system ceiling?
     if (uxTaskPriorityGet(NULL) > system_ceiling)
     {
       if (ADDITIONAL_DEBUG_MESSAGES)
-        printf("Resource access granted due to task prio superiority\n");
+        BINLOG("Resource access granted due to task prio superiority\n");
       break;
     }
     // 2. If not, do I hold a resource with a ceiling equal to the system ceiling (except this one)?
     if (getMaxCeilingListValue(current_task_profile->task_ceiling_list) == system_ceiling)
     {
       if (ADDITIONAL_DEBUG_MESSAGES)
-        printf("Resource access granted due to superior resource held\n");
+        BINLOG("Resource access granted due to superior resource held\n");
     }
     // If none is true:
     if (ADDITIONAL_DEBUG_MESSAGES)
-      printf("Resource access denied; ceiling-block\n");
+      BINLOG("Resource access denied; ceiling-block\n");
     // Give up the resource semaphore again
     xSemaphoreGive(cs_semaphore->semaphore);
     // Empty your global task semaphore and wait in it
@@ -207,31 +216,33 @@ void usPrioritySemaphoreWait(CriticalSectionSemaphore *cs_semaphore)
   cs_semaphore->last_priority = uxTaskPriorityGet(NULL);
   // Task's priority becomes the resource's ceiling
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("Task priority set to %lu\n", cs_semaphore->resource_ceiling);
-  vTaskPrioritySet(NULL, cs_semaphore->resource_ceiling);
+    BINLOG("Task priority set to %lu\n", cs_semaphore->resource_ceiling);
+  CYCLESTAT_MEASURE(priority_site, vTaskPrioritySet(NULL, cs_semaphore->resource_ceiling));
   current_task_profile->task_params->priority = cs_semaphore->resource_ceiling;
   // Add resource ceiling to active system ceilings
   addToCeilingList(active_system_ceilings, cs_semaphore->resource_ceiling);
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("System ceiling is %lu\n", getMaxCeilingListValue(active_system_ceilings));
+    BINLOG("System ceiling is %lu\n", getMaxCeilingListValue(active_system_ceilings));
   // Add resource ceiling to held ceilings
   addToCeilingList(current_task_profile->task_ceiling_list, cs_semaphore->resource_ceiling);
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("Resource ceiling is %lu\n", getMaxCeilingListValue(current_task_profile->task_ceiling_list));
+    BINLOG("Resource ceiling is %lu\n", getMaxCeilingListValue(current_task_profile->task_ceiling_list));
+  CYCLESTAT_END(wait_site, wait_span);
   // ACCESS RESOURCE
 }
 
 void usPrioritySemaphoreSignal(CriticalSectionSemaphore *cs_semaphore)
 {
+  CYCLESTAT_BEGIN(signal_span);
   TaskProfile *current_task_profile = getCurrentTaskProfile();
   // Remove resource from held ceilings
   removeFromCeilingList(current_task_profile->task_ceiling_list, cs_semaphore->resource_ceiling);
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("Resource ceiling is %lu\n", getMaxCeilingListValue(current_task_profile->task_ceiling_list));
+    BINLOG("Resource ceiling is %lu\n", getMaxCeilingListValue(current_task_profile->task_ceiling_list));
   // Remove resource from active system ceilings
   removeFromCeilingList(active_system_ceilings, cs_semaphore->resource_ceiling);
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("System ceiling is %lu\n", getMaxCeilingListValue(active_system_ceilings));
+    BINLOG("System ceiling is %lu\n", getMaxCeilingListValue(active_system_ceilings));
   // Release resource semaphore
   xSemaphoreGive(cs_semaphore->semaphore);
   // Wake all global semaphores in their task priority order
@@ -239,7 +250,9 @@ void usPrioritySemaphoreSignal(CriticalSectionSemaphore *cs_semaphore)
 
   // Reset your priority to the value stored in the semaphore earlier
   if (ADDITIONAL_DEBUG_MESSAGES)
-    printf("Task priority set to %lu\n", cs_semaphore->last_priority);
+    BINLOG("Task priority set to %lu\n", cs_semaphore->last_priority);
   current_task_profile->task_params->priority = cs_semaphore->last_priority;
-  vTaskPrioritySet(NULL, cs_semaphore->last_priority);
+  // Lowering the priority may switch to another task right away
+  CYCLESTAT_END(signal_site, signal_span);
+  CYCLESTAT_MEASURE(priority_site, vTaskPrioritySet(NULL, cs_semaphore->last_priority));
 }
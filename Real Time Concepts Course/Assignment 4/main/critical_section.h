@@ -1,6 +1,8 @@
 #ifndef ICPP_CRITICAL_SECTION_H
 #define ICPP_CRITICAL_SECTION_H
 
+#include "binlog.h"
+#include "cyclestat.h"
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
@@ -1,6 +1,10 @@
 #include "display.h"
 
 ssd1306_handle_t ssd1306_dev = NULL;
+Framebuffer framebuffer;
+
+static void render_state(const void *snapshot);
+
 void ssd1306_setup() {
   i2c_config_t conf;
   conf.mode = I2C_MODE_MASTER;
@@ -16,28 +20,33 @@ void ssd1306_setup() {
 
   // deprecated, you can get bonus points for updating it ;-)
   ssd1306_dev = ssd1306_create(I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
-  ssd1306_refresh_gram(ssd1306_dev);
-  ssd1306_clear_screen(ssd1306_dev, 0x00);
+  // only changed page segments are sent from here on, see framebuffer.h
+  framebuffer_init(&framebuffer, I2C_MASTER_NUM, SSD1306_I2C_ADDRESS);
+  // from here on, only the display server talks to the display
+  display_server_start(render_state, sizeof(DisplayedState),
+                       DISPLAY_SERVER_PRIORITY,
+                       pdMS_TO_TICKS(1000UL / DISPLAY_MAX_FRAME_RATE));
 }
 
-void ssd1306_print(DisplayedState *state) {
+static void render_state(const void *snapshot) {
+  const DisplayedState *state = snapshot;
   char val[20];
-  ssd1306_clear_screen(ssd1306_dev, 0x00);
+  framebuffer_clear(&framebuffer);
   // print tick
-  ssd1306_draw_string(ssd1306_dev, 10, 0, (const uint8_t *)"Tick", 16, 1);
+  framebuffer_draw_string(&framebuffer, 10, 0, "Tick", 16, 1);
   snprintf(val, 10, "%lu", state->tick - 1);
-  ssd1306_draw_string(ssd1306_dev, 70, 0, (const uint8_t *)val, 16, 1);
+  framebuffer_draw_string(&framebuffer, 70, 0, val, 16, 1);
   // print running task
-  ssd1306_draw_string(ssd1306_dev, 10, 16, (const uint8_t *)"Tasks in CS:", 16,
-                      1);
+  framebuffer_draw_string(&framebuffer, 10, 16, "Tasks in CS:", 16, 1);
 
   for (int r = 0; r < RESOURCES; r++) {
     if (state->task_in_cs[r] != NULL) {
       snprintf(val, 20, "R%d: %s", r, state->task_in_cs[r]);
-      ssd1306_draw_string(ssd1306_dev, 10 + r * 50, 32, (const uint8_t *)val,
-                          16, 1);
+      framebuffer_draw_string(&framebuffer, 10 + r * 50, 32, val, 16, 1);
     }
   }
 
-  ssd1306_refresh_gram(ssd1306_dev);
+  display_server_flush(&framebuffer);
 }
+
+void ssd1306_print(DisplayedState *state) { display_server_post(state); }
@@ -4,6 +4,8 @@
 /* No need to change anything here... */
 
 #include "critical_section.h"
+#include "display_server.h"
+#include "framebuffer.h"
 #include "freertos/FreeRTOS.h"
 #include "sdkconfig.h"
 #include "ssd1306.h"
@@ -14,6 +16,8 @@
 #define I2C_MASTER_NUM I2C_NUM_1
 #define I2C_MASTER_FREQ_HZ 100000
 
+#define DISPLAY_MAX_FRAME_RATE 10
+
 typedef struct {
   TickType_t tick;
   char *task_in_cs[RESOURCES];
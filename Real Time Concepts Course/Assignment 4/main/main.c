@@ -11,6 +11,11 @@
 #define TASK2_PRIORITY (tskIDLE_PRIORITY + 3)
 #define TASK3_PRIORITY (tskIDLE_PRIORITY + 1)
 
+// print the ICPP overhead if CYCLESTAT_ENABLED, see cyclestat.h
+#define CYCLESTAT_REPORT_INTERVAL_MS 10000
+// load of the tasks in their time units, see workload.h
+#define LOAD_KERNEL WORKLOAD_CPU
+
 CriticalSectionSemaphore cs1_semaphore;
 CriticalSection task1_cs1 = {.resource = 0, .start = 2, .end = 3};
 CriticalSection task3_cs1 = {.resource = 0, .start = 2, .end = 5};
@@ -44,7 +49,9 @@ TickingTaskParams ticking_task_params = {
     .task_params = {&task1_params, &task2_params, &task3_params}};
 
 void app_main(void) {
-  task_setup();
+  task_setup(LOAD_KERNEL);
+  binlog_start(tskIDLE_PRIORITY);
+  cyclestat_start(tskIDLE_PRIORITY, CYCLESTAT_REPORT_INTERVAL_MS);
   ssd1306_setup();
 
   PeriodicTaskParams *cs1_tasks[2] = {&task1_params, &task3_params};
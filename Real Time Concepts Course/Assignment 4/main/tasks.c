@@ -4,18 +4,18 @@
 DisplayedState state;
 SemaphoreHandle_t button_semaphore, tick_semaphore, blinking_semaphore;
 TickType_t last_button_press = 0;
+static WorkloadKernel load_kernel;
 
-void busy_waiting(TickType_t until) {
-  while (xTaskGetTickCount() < until) {
-  }
-}
-
+/* Useless load for 'duration' time units. The task keeps the CPU busy with
+ * the calibrated kernel of task_setup until the ticking task starts the
+ * next unit. */
 void task_useless_load(PeriodicTaskParams *params, TickType_t duration) {
   TickType_t i;
+  uint64_t blink_cycles = workload_ms_to_cycles(BLINKING_SLEEP_MS);
 
   for (i = 0; i < duration; ++i) {
     xSemaphoreTake(tick_semaphore, portMAX_DELAY);
-    printf("EXEC: Task %s (%lu/%lu)\n", params->id, params->elapsed_time + 1,
+    BINLOG("EXEC: Task %s (%lu/%lu)\n", params->id, params->elapsed_time + 1,
            params->execution_time);
     // update display information
     ssd1306_print(&state);
@@ -23,10 +23,9 @@ void task_useless_load(PeriodicTaskParams *params, TickType_t duration) {
     // continue blinking until button is pressed again
     int current_tick = state.tick;
     while (current_tick == state.tick) {
-      TickType_t time_unit_start = xTaskGetTickCount();
-      busy_waiting(time_unit_start + pdMS_TO_TICKS(BLINKING_SLEEP_MS));
+      workload_run(load_kernel, blink_cycles);
       gpio_set_level(params->gpio, 0);
-      busy_waiting(time_unit_start + 2 * pdMS_TO_TICKS(BLINKING_SLEEP_MS));
+      workload_run(load_kernel, blink_cycles);
       gpio_set_level(params->gpio, 1);
     }
     params->elapsed_time++;
@@ -41,7 +40,7 @@ void periodic_task_implementation(void *v_params) {
 
   // trigger LED, indicating that task is ready
   gpio_set_level(params->gpio, 1);
-  printf("RELEASE: Task %s\n", params->id);
+  BINLOG("RELEASE: Task %s\n", params->id);
   params->elapsed_time = 0;
 
   // task execution, including critical sections
@@ -52,24 +51,24 @@ void periodic_task_implementation(void *v_params) {
     task_useless_load(params, cs.start - params->elapsed_time);
 
     // critical section
-    printf("CS (AWAIT): Task %s (%d/%u)\n", params->id, i + 1,
-           params->no_of_critical_sections);
+    BINLOG("CS (AWAIT): Task %s (%d/%u)\n", params->id, i + 1,
+           (unsigned int)params->no_of_critical_sections);
     usPrioritySemaphoreWait(cs.semaphore);
     params->priority = uxTaskPriorityGet(NULL);
-    printf("CS (ENTER): Task %s (%d/%u)\n", params->id, i + 1,
-           params->no_of_critical_sections);
+    BINLOG("CS (ENTER): Task %s (%d/%u)\n", params->id, i + 1,
+           (unsigned int)params->no_of_critical_sections);
     state.task_in_cs[cs.resource] = params->id;
     task_useless_load(params, cs.end - cs.start);
     state.task_in_cs[cs.resource] = NULL;
-    printf("CS (LEAVE): Task %s (%d/%u)\n", params->id, i + 1,
-           params->no_of_critical_sections);
+    BINLOG("CS (LEAVE): Task %s (%d/%u)\n", params->id, i + 1,
+           (unsigned int)params->no_of_critical_sections);
     usPrioritySemaphoreSignal(cs.semaphore);
     params->priority = uxTaskPriorityGet(NULL);
   }
   task_useless_load(params, params->execution_time - params->elapsed_time);
   gpio_set_level(params->gpio, 0);
 
-  printf("COMPLETE: Task %s\n", params->id);
+  BINLOG("COMPLETE: Task %s\n", params->id);
 
   // delete task instance
   vTaskDelete(NULL);
@@ -104,7 +103,10 @@ void IRAM_ATTR gpio_isr_handler(void *arg) {
   }
 }
 
-void task_setup() {
+void task_setup(WorkloadKernel kernel) {
+  load_kernel = kernel;
+  workload_calibrate();
+
   // GPIO setup to increase tick when button is pressed
   gpio_config_t io_conf_in = {.pin_bit_mask = GPIO_INPUT_PIN_SEL,
                               .mode = GPIO_MODE_INPUT,
@@ -3,11 +3,13 @@
 
 /* No need to change anything here... */
 
+#include "binlog.h"
 #include "critical_section.h"
 #include "display.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "workload.h"
 #include <inttypes.h>
 
 #define TICKS_PER_SECOND pdMS_TO_TICKS(1000UL)
@@ -46,6 +48,6 @@ typedef struct {
 void task_useless_load(PeriodicTaskParams *params, TickType_t duration);
 void periodic_task_implementation(void *v_params);
 void ticking_task_implementation(void *vparams);
-void task_setup();
+void task_setup(WorkloadKernel kernel);
 
 #endif
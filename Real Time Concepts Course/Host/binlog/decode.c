@@ -0,0 +1,149 @@
+/* binlog_decode: text of the '#BL' records the drain task of the binlog
+ * component streams with BINLOG_ENCODED_OUTPUT.
+ *
+ * Reads the console output of an assignment (a file or stdin), rebuilds the
+ * text of every record from the dictionary lines in the stream and prefixes
+ * it with its timestamp in seconds. Other lines are passed through. */
+
+#include "binlog_format.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DECODE_LINE_LENGTH 4096
+#define DECODE_TEXT_LENGTH 1024
+#define DICTIONARY_LENGTH 4096 // a power of two
+
+typedef struct {
+  uint64_t address;
+  char *text;
+} DictionaryEntry;
+
+typedef struct {
+  DictionaryEntry entries[DICTIONARY_LENGTH];
+  unsigned int word_bits;
+  bool started;
+  uint32_t last_timestamp;
+  uint64_t time_us; // timestamp extended across the 32 bit wrap around
+} Decoder;
+
+static DictionaryEntry *lookup(Decoder *decoder, uint64_t address) {
+  unsigned int index = (address >> 2) % DICTIONARY_LENGTH;
+  for (unsigned int probe = 0; probe < DICTIONARY_LENGTH; probe++) {
+    DictionaryEntry *entry =
+        &decoder->entries[(index + probe) % DICTIONARY_LENGTH];
+    if (entry->text == NULL || entry->address == address)
+      return entry;
+  }
+  return NULL;
+}
+
+static const char *string_argument(BinlogWord address, void *context) {
+  DictionaryEntry *entry = lookup(context, address);
+  return entry != NULL ? entry->text : NULL;
+}
+
+// '#BLS <address> <hex text>'
+static void decode_string(Decoder *decoder, char *fields) {
+  char *hex;
+  uint64_t address = strtoull(fields, &hex, 16);
+  while (*hex == ' ')
+    hex++;
+  DictionaryEntry *entry = lookup(decoder, address);
+  if (entry == NULL) {
+    fprintf(stderr, "ERROR: Dictionary full\n");
+    return;
+  }
+
+  size_t length = strspn(hex, "0123456789abcdefABCDEF") / 2;
+  char *text = malloc(length + 1);
+  for (size_t i = 0; i < length; i++) {
+    char byte[3] = {hex[2 * i], hex[2 * i + 1], '\0'};
+    text[i] = (char)strtoul(byte, NULL, 16);
+  }
+  text[length] = '\0';
+  free(entry->text);
+  entry->address = address;
+  entry->text = text;
+}
+
+// '#BLR <core> <timestamp> <format> <args>...'
+static void decode_record(Decoder *decoder, char *fields) {
+  BinlogWord args[16];
+  unsigned int count = 0;
+  char *next;
+
+  strtoul(fields, &next, 10);
+  uint32_t timestamp = strtoul(next, &next, 16);
+  uint64_t format = strtoull(next, &next, 16);
+  while (count < sizeof(args) / sizeof(args[0])) {
+    char *end;
+    BinlogWord word = strtoull(next, &end, 16);
+    if (end == next)
+      break;
+    args[count++] = word;
+    next = end;
+  }
+
+  // records of different cores may be slightly out of order
+  if (decoder->started)
+    decoder->time_us += (int32_t)(timestamp - decoder->last_timestamp);
+  else
+    decoder->time_us = timestamp;
+  decoder->started = true;
+  decoder->last_timestamp = timestamp;
+
+  char text[DECODE_TEXT_LENGTH];
+  DictionaryEntry *entry = lookup(decoder, format);
+  if (entry == NULL || entry->text == NULL) {
+    snprintf(text, sizeof(text), "<unknown format %" PRIx64 ">\n", format);
+  } else {
+    binlog_format(text, sizeof(text), entry->text, args, count,
+                  decoder->word_bits, string_argument, decoder);
+  }
+  printf("[%4" PRIu64 ".%06" PRIu64 "] %s", decoder->time_us / 1000000,
+         decoder->time_us % 1000000, text);
+  if (text[0] == '\0' || text[strlen(text) - 1] != '\n')
+    printf("\n");
+}
+
+static void decode_line(Decoder *decoder, char *line) {
+  if (strncmp(line, "#BLS ", 5) == 0) {
+    decode_string(decoder, line + 5);
+  } else if (strncmp(line, "#BLR ", 5) == 0) {
+    decode_record(decoder, line + 5);
+  } else if (strncmp(line, "#BLH ", 5) == 0) {
+    decoder->word_bits = strtoul(line + 5, NULL, 10);
+  } else if (strncmp(line, "#BLD ", 5) == 0) {
+    unsigned int core = 0;
+    unsigned long dropped = 0;
+    sscanf(line + 5, "%u %lu", &core, &dropped);
+    printf("BINLOG: %lu records of core %u dropped in total\n", dropped, core);
+  } else {
+    fputs(line, stdout);
+  }
+}
+
+int main(int argc, char **argv) {
+  FILE *input = stdin;
+  if (argc > 2 || (argc == 2 && strcmp(argv[1], "-h") == 0)) {
+    fprintf(stderr, "Usage: %s [console log]\n", argv[0]);
+    return argc == 2 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (argc == 2 && (input = fopen(argv[1], "r")) == NULL) {
+    fprintf(stderr, "ERROR: Cannot open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  static Decoder decoder;
+  decoder.word_bits = 32; // the ESP32, unless the stream says otherwise
+  char line[DECODE_LINE_LENGTH];
+  while (fgets(line, sizeof(line), input) != NULL)
+    decode_line(&decoder, line);
+
+  if (input != stdin)
+    fclose(input);
+  return EXIT_SUCCESS;
+}
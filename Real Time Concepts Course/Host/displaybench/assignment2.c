@@ -0,0 +1,29 @@
+#include "display.h"
+#include "scenario.h"
+
+const char *const scenario_name =
+    "Assignment 2: task info and sensitivity pages";
+
+// task set of app_main with the results it displays
+static TaskParams tasks[3] = {
+    {.id = 1, .execution_time = 2, .period = 4, .deadline = 4},
+    {.id = 2, .execution_time = 2, .period = 7, .deadline = 7},
+    {.id = 3, .execution_time = 1, .period = 8, .deadline = 8}};
+static TaskInfo task_info[3] = {
+    {.util = 0.5, .wcs_result = 2, .tda_result = 2, .sim_result = 2,
+     .max_execution_time = 3, .min_period = 2, .breakdown_util = 1.094},
+    {.util = 0.786, .wcs_result = 4, .tda_result = 4, .sim_result = 4,
+     .max_execution_time = 3, .min_period = 5, .breakdown_util = 1.094},
+    {.util = 0.911, .wcs_result = 7, .tda_result = 7, .sim_result = 7,
+     .max_execution_time = 1, .min_period = 7, .breakdown_util = 1.094}};
+
+void scenario_setup(void) { ssd1306_setup(); }
+
+// same order as the display loop of app_main
+void scenario_step(unsigned long step) {
+  unsigned int task = (step / 2) % 3;
+  if (step % 2 == 0)
+    ssd1306_print_task_info(&tasks[task], &task_info[task]);
+  else
+    ssd1306_print_sensitivity(&tasks[task], &task_info[task]);
+}
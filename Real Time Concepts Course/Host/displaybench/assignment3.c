@@ -0,0 +1,11 @@
+#include "display.h"
+#include "scenario.h"
+
+const char *const scenario_name =
+    "Assignment 3: snowman animation of the aperiodic job";
+
+void scenario_setup(void) { ssd1306_setup(); }
+
+void scenario_step(unsigned long step) {
+  ssd1306_print_snowman_frame(step % SNOWMAN_FRAMES);
+}
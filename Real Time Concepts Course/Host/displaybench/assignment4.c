@@ -0,0 +1,22 @@
+#include "display.h"
+#include "scenario.h"
+
+const char *const scenario_name = "Assignment 4: ssd1306_print every tick";
+
+#define SCHEDULE_TICKS 14
+
+/* Holder of resource 0 in the ICPP schedule of the task set of app_main:
+ * T3 runs 0-1, holds R0 2-4 (blocking T1), T1 runs 5-8 with R0 at 7,
+ * T2 runs 9-12 and T3 completes at 13. Every tick is one display update. */
+static char *const resource0_holder[SCHEDULE_TICKS] = {
+    NULL, NULL, "T3", "T3", "T3", NULL, NULL,
+    "T1", NULL, NULL, NULL, NULL, NULL, NULL};
+
+void scenario_setup(void) { ssd1306_setup(); }
+
+void scenario_step(unsigned long step) {
+  DisplayedState state = {.tick = step + 1};
+  state.task_in_cs[0] = resource0_holder[step % SCHEDULE_TICKS];
+  state.task_in_cs[1] = NULL;
+  ssd1306_print(&state);
+}
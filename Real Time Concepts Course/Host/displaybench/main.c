@@ -0,0 +1,100 @@
+/* displaybench: bus traffic of the display code of the assignments.
+ *
+ * Runs the display calls of one assignment against the host model of the
+ * I2C bus and the SSD1306 (see host_display.h) and reports the bytes,
+ * transactions and wire time per frame at the I2C frequency the assignment
+ * configures. Every run is done twice: with the partial refresh of the
+ * framebuffer component, and with a full refresh of the panel for every
+ * frame as the baseline. Afterwards, the decoded panel content has to match
+ * the framebuffer. */
+
+#include "host_display.h"
+#include "scenario.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  HostI2cStats setup;
+  HostI2cStats frames;
+  unsigned long number_of_frames;
+  bool panel_matches;
+} RunResult;
+
+static void invalidate_framebuffer(void) {
+  framebuffer_invalidate(&framebuffer);
+}
+
+static RunResult run(unsigned long frames, bool full_refresh) {
+  RunResult result;
+
+  host_display_server_hook(NULL);
+  scenario_setup();
+  result.setup = host_i2c_stats(framebuffer.port);
+  host_i2c_reset_stats(framebuffer.port);
+
+  host_display_server_hook(full_refresh ? invalidate_framebuffer : NULL);
+  uint32_t first_frame = framebuffer.frames;
+  for (unsigned long step = 0; framebuffer.frames - first_frame < frames;
+       step++)
+    scenario_step(step);
+
+  result.frames = host_i2c_stats(framebuffer.port);
+  result.number_of_frames = framebuffer.frames - first_frame;
+  result.panel_matches = memcmp(host_ssd1306_gram(), framebuffer.pixels,
+                                sizeof(framebuffer.pixels)) == 0;
+  host_i2c_reset_stats(framebuffer.port);
+  return result;
+}
+
+static void print_row(const char *name, const RunResult *result) {
+  double frames = result->number_of_frames;
+  printf("%-8s %7lu %12.1f %13.1f %14.2f  %s\n", name,
+         result->number_of_frames, result->frames.bytes / frames,
+         result->frames.transactions / frames,
+         host_i2c_wire_time_us(&result->frames) / 1000.0 / frames,
+         result->panel_matches ? "ok" : "MISMATCH");
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -n FRAMES       frames to render per run (default 100)\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  unsigned long frames = 100;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      frames = strtoul(optarg, NULL, 10);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (frames == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  RunResult partial = run(frames, false);
+  RunResult full = run(frames, true);
+
+  printf("%s\n", scenario_name);
+  printf("I2C at %u Hz, setup %llu bytes in %llu transactions (%.2f ms)\n\n",
+         partial.setup.frequency, partial.setup.bytes,
+         partial.setup.transactions,
+         host_i2c_wire_time_us(&partial.setup) / 1000.0);
+  printf("%-8s %7s %12s %13s %14s  %s\n", "refresh", "frames", "bytes/frame",
+         "txns/frame", "bus ms/frame", "panel");
+  print_row("partial", &partial);
+  print_row("full", &full);
+  return partial.panel_matches && full.panel_matches ? EXIT_SUCCESS
+                                                     : EXIT_FAILURE;
+}
@@ -0,0 +1,19 @@
+#ifndef DISPLAYBENCH_SCENARIO_H
+#define DISPLAYBENCH_SCENARIO_H
+
+/* The display calls of one assignment. Every assignment is linked into its
+ * own binary, as their display.c define the same symbols. */
+
+#include "framebuffer.h"
+
+extern const char *const scenario_name;
+
+// framebuffer of the assignment's display.c
+extern Framebuffer framebuffer;
+
+void scenario_setup(void);
+
+// Issue the display calls of step 'step', i.e., one or more frames
+void scenario_step(unsigned long step);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_CPU_H
+#define HOST_ESP_CPU_H
+
+#include <stdint.h>
+
+// Nanoseconds of a monotonic clock stand in for CPU cycles on the host
+uint32_t esp_cpu_get_cycle_count(void);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_FLASH_H
+#define HOST_ESP_FLASH_H
+
+/* Intentionally empty on the host. */
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/* Host stand-in for the parts of FreeRTOS used by the assignments.
+ * Only types, constants and prototypes live here; the implementation is
+ * provided by platform/freertos.c. */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned long TickType_t;
+typedef unsigned long UBaseType_t;
+typedef long BaseType_t;
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+
+#define configTICK_RATE_HZ 100
+#define configMINIMAL_STACK_SIZE 768
+#define configMAX_PRIORITIES 25
+#define configMAX_TASK_NAME_LEN 16
+#define portMAX_DELAY ((TickType_t)ULONG_MAX)
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)                                                      \
+  ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define tskIDLE_PRIORITY 0
+#define IRAM_ATTR
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+// a single core without interrupts, unless a simulator sets the cores
+#ifndef portNUM_PROCESSORS
+#define portNUM_PROCESSORS 1
+#endif
+#define portSET_INTERRUPT_MASK_FROM_ISR() ((UBaseType_t)0)
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(mask) ((void)(mask))
+
+// spinlocks of the critical sections between cores
+typedef struct {
+  uint32_t owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+void *pvPortMalloc(size_t size);
+void vPortFree(void *ptr);
+BaseType_t xPortGetCoreID(void);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+/* Queues only appear in declarations on the host. */
+typedef void *QueueHandle_t;
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef HOST_DISPLAY_H
+#define HOST_DISPLAY_H
+
+/* Host model of the I2C bus and the SSD1306 panel of the assignments.
+ * Every transaction is decoded by the device at its address. The SSD1306
+ * model keeps the display RAM and interprets the addressing commands, so
+ * the panel content can be compared with what the assignments drew. */
+
+#include "driver/i2c.h"
+#include <stdbool.h>
+
+#define HOST_SSD1306_PAGES 8
+#define HOST_SSD1306_WIDTH 128
+
+typedef struct {
+  unsigned long long transactions;
+  unsigned long long bytes;      // including the address byte
+  unsigned long long bit_clocks; // SCL periods incl. ACK, START and STOP
+  uint32_t frequency;            // clk_speed of i2c_param_config
+} HostI2cStats;
+
+HostI2cStats host_i2c_stats(i2c_port_t port);
+void host_i2c_reset_stats(i2c_port_t port);
+
+// Time the transactions so far occupy the bus, in microseconds
+double host_i2c_wire_time_us(const HostI2cStats *stats);
+
+/* Called by the bus for every write transaction to 'address', with the
+ * bytes following the address byte. Returns false if no device answers. */
+bool host_ssd1306_receive(uint8_t address, const uint8_t *data,
+                          size_t length);
+
+// Display RAM of the panel, in page layout
+const uint8_t (*host_ssd1306_gram(void))[HOST_SSD1306_WIDTH];
+
+/* The display server renders synchronously on the host. 'hook' is called
+ * before every frame, e.g., to force full refreshes for a baseline. */
+void host_display_server_hook(void (*hook)(void));
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_SSD1306_H
+#define HOST_SSD1306_H
+
+/* Host stand-in for the espressif/ssd1306 component. The panel is modeled by
+ * platform/ssd1306.c, see host_display.h. */
+
+#include "driver/gpio.h"
+#include "driver/i2c.h"
+
+#define SSD1306_I2C_ADDRESS 0x3C
+
+typedef void *ssd1306_handle_t;
+
+ssd1306_handle_t ssd1306_create(i2c_port_t port, const uint16_t dev_addr);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_SSD1306_FONTS_H
+#define HOST_SSD1306_FONTS_H
+
+#include <stdint.h>
+
+/* Placeholder glyphs with the footprint of the real fonts, generated by
+ * ssd1306_create (see platform/ssd1306.c). */
+extern uint8_t c_chFont1206[95][12];
+extern uint8_t c_chFont1608[95][16];
+
+#endif
@@ -0,0 +1,32 @@
+#include "display_server.h"
+#include "host_display.h"
+
+/* The host has no scheduler, so every posted snapshot is rendered right
+ * away in the caller. Nothing is coalesced or superseded. */
+
+static DisplayRenderFunction render = NULL;
+static void (*before_render)(void) = NULL;
+static DisplayServerStats stats;
+
+bool display_server_start(DisplayRenderFunction render_function,
+                          size_t snapshot_size, UBaseType_t priority,
+                          TickType_t frame_interval) {
+  render = render_function;
+  stats = (DisplayServerStats){0, 0, 0};
+  return true;
+}
+
+bool display_server_post(const void *snapshot) {
+  if (render == NULL)
+    return false;
+  stats.posted++;
+  if (before_render != NULL)
+    before_render();
+  render(snapshot);
+  stats.rendered++;
+  return true;
+}
+
+DisplayServerStats display_server_stats() { return stats; }
+
+void host_display_server_hook(void (*hook)(void)) { before_render = hook; }
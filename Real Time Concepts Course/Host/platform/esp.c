@@ -0,0 +1,34 @@
+#include "driver/gpio.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include <time.h>
+
+uint32_t esp_cpu_get_cycle_count(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+int64_t esp_timer_get_time(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *handle) {
+  return ESP_FAIL;
+}
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  return ESP_FAIL;
+}
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) { return ESP_FAIL; }
+
+// There are no LEDs or buttons on the host
+esp_err_t gpio_config(const gpio_config_t *config) { return ESP_OK; }
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) { return ESP_OK; }
+esp_err_t gpio_install_isr_service(int flags) { return ESP_OK; }
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, gpio_isr_t handler,
+                               void *args) {
+  return ESP_OK;
+}
@@ -0,0 +1,93 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdio.h>
+
+/* Minimal FreeRTOS for host tools that only use the analysis and display
+ * code of the assignments. The heap is forwarded to malloc and time is
+ * virtual: vTaskDelay only advances the tick count. The remaining scheduling
+ * API exists so that the assignment sources link, but must not be called. */
+
+static void unsupported(const char *function) {
+  fprintf(stderr, "ERROR: %s is not available in the host build\n", function);
+  abort();
+}
+
+void *pvPortMalloc(size_t size) { return malloc(size); }
+void vPortFree(void *ptr) { free(ptr); }
+BaseType_t xPortGetCoreID(void) { return 0; }
+
+static TickType_t tick_count = 0;
+
+TickType_t xTaskGetTickCount(void) { return tick_count; }
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name,
+                       uint32_t stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+  unsupported(__func__);
+  return pdFAIL;
+}
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name,
+                                   uint32_t stack_depth, void *params,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  unsupported(__func__);
+  return pdFAIL;
+}
+void vTaskDelete(TaskHandle_t task) { unsupported(__func__); }
+void vTaskDelay(TickType_t ticks) { tick_count += ticks; }
+void vTaskDelayUntil(TickType_t *previous_wake_time, TickType_t increment) {
+  unsupported(__func__);
+}
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority) {
+  unsupported(__func__);
+}
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+  unsupported(__func__);
+  return 0;
+}
+eTaskState eTaskGetState(TaskHandle_t task) {
+  unsupported(__func__);
+  return eInvalid;
+}
+void vTaskSuspend(TaskHandle_t task) { unsupported(__func__); }
+void vTaskResume(TaskHandle_t task) { unsupported(__func__); }
+// there is no other task to hold off
+void vTaskSuspendAll(void) {}
+BaseType_t xTaskResumeAll(void) { return pdFALSE; }
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  unsupported(__func__);
+  return NULL;
+}
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  unsupported(__func__);
+  return pdFAIL;
+}
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+  unsupported(__func__);
+  return 0;
+}
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_prio_woken) {
+  unsupported(__func__);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  unsupported(__func__);
+  return NULL;
+}
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  unsupported(__func__);
+  return NULL;
+}
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  unsupported(__func__);
+  return pdFAIL;
+}
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  unsupported(__func__);
+  return pdFAIL;
+}
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+  unsupported(__func__);
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include "host_display.h"
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include <stdio.h>
+
+/* Model of a 128x64 SSD1306 on I2C. Every transaction starts with a control
+ * byte: bit 6 selects data (display RAM) or commands, and if bit 7 (Co) is
+ * set only the next byte uses it and another control byte follows. */
+
+#define SSD1306_CONTROL_CONTINUATION 0x80
+#define SSD1306_CONTROL_DATA 0x40
+
+typedef enum {
+  ADDRESSING_HORIZONTAL = 0,
+  ADDRESSING_VERTICAL = 1,
+  ADDRESSING_PAGE = 2
+} AddressingMode;
+
+typedef struct {
+  bool present;
+  uint8_t address;
+  uint8_t gram[HOST_SSD1306_PAGES][HOST_SSD1306_WIDTH];
+  AddressingMode mode;
+  uint8_t column, column_start, column_end;
+  uint8_t page, page_start, page_end;
+  uint8_t command; // command waiting for its arguments
+  uint8_t arguments[6];
+  uint8_t received, expected;
+} Ssd1306Model;
+
+static Ssd1306Model panel;
+
+uint8_t c_chFont1206[95][12];
+uint8_t c_chFont1608[95][16];
+
+static uint8_t command_arguments(uint8_t command) {
+  switch (command) {
+  case 0x26: // horizontal scroll setup
+  case 0x27:
+    return 6;
+  case 0x29: // vertical and horizontal scroll setup
+  case 0x2A:
+    return 5;
+  case 0x21: // column address
+  case 0x22: // page address
+  case 0xA3: // vertical scroll area
+    return 2;
+  case 0x20: // memory addressing mode
+  case 0x81: // contrast
+  case 0x8D: // charge pump
+  case 0xA8: // multiplex ratio
+  case 0xAD: // internal IREF
+  case 0xD3: // display offset
+  case 0xD5: // clock divide ratio
+  case 0xD9: // pre-charge period
+  case 0xDA: // COM pins
+  case 0xDB: // VCOMH deselect level
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static void execute_command(Ssd1306Model *model) {
+  uint8_t command = model->command, *arguments = model->arguments;
+
+  if (command == 0x20) {
+    model->mode = arguments[0] & 0x03;
+  } else if (command == 0x21) {
+    model->column_start = arguments[0] % HOST_SSD1306_WIDTH;
+    model->column_end = arguments[1] % HOST_SSD1306_WIDTH;
+    model->column = model->column_start;
+  } else if (command == 0x22) {
+    model->page_start = arguments[0] % HOST_SSD1306_PAGES;
+    model->page_end = arguments[1] % HOST_SSD1306_PAGES;
+    model->page = model->page_start;
+  } else if (command >= 0xB0 && command <= 0xB7) {
+    model->page = command & 0x07;
+  } else if (command <= 0x0F) {
+    model->column = (model->column & 0xF0) | command;
+  } else if (command >= 0x10 && command <= 0x17) {
+    model->column = (model->column & 0x0F) | ((command & 0x07) << 4);
+  }
+  // display on/off, contrast, scrolling etc. do not change the RAM
+}
+
+static void receive_command(Ssd1306Model *model, uint8_t byte) {
+  if (model->received < model->expected) {
+    model->arguments[model->received++] = byte;
+  } else {
+    model->command = byte;
+    model->received = 0;
+    model->expected = command_arguments(byte);
+  }
+  if (model->received == model->expected)
+    execute_command(model);
+}
+
+static void receive_data(Ssd1306Model *model, uint8_t byte) {
+  model->gram[model->page][model->column] = byte;
+
+  if (model->mode == ADDRESSING_PAGE) {
+    model->column = (model->column + 1) % HOST_SSD1306_WIDTH;
+  } else if (model->mode == ADDRESSING_HORIZONTAL) {
+    if (model->column++ == model->column_end) {
+      model->column = model->column_start;
+      model->page = model->page == model->page_end ? model->page_start
+                                                   : model->page + 1;
+    }
+  } else {
+    if (model->page++ == model->page_end) {
+      model->page = model->page_start;
+      model->column = model->column == model->column_end
+                          ? model->column_start
+                          : model->column + 1;
+    }
+  }
+}
+
+bool host_ssd1306_receive(uint8_t address, const uint8_t *data,
+                          size_t length) {
+  if (!panel.present || address != panel.address)
+    return false;
+
+  size_t i = 0;
+  while (i < length) {
+    uint8_t control = data[i++];
+    size_t end = length;
+    if ((control & SSD1306_CONTROL_CONTINUATION) && i + 1 < length)
+      end = i + 1;
+    for (; i < end; i++) {
+      if (control & SSD1306_CONTROL_DATA)
+        receive_data(&panel, data[i]);
+      else
+        receive_command(&panel, data[i]);
+    }
+  }
+  return true;
+}
+
+const uint8_t (*host_ssd1306_gram(void))[HOST_SSD1306_WIDTH] {
+  return (const uint8_t(*)[HOST_SSD1306_WIDTH])panel.gram;
+}
+
+/* Blank spacing column on both sides and a pattern that depends on the
+ * character in between, so that changed text changes the same columns as
+ * with the real fonts. */
+static void generate_fonts() {
+  for (int chr = 1; chr < 95; chr++) {
+    for (int column = 1; column < 5; column++) {
+      c_chFont1206[chr][2 * column] = (uint8_t)(0x7E ^ (chr * (column + 1)));
+      c_chFont1206[chr][2 * column + 1] = 0x60;
+    }
+    for (int column = 1; column < 7; column++) {
+      c_chFont1608[chr][2 * column] = (uint8_t)(0x3F ^ (chr * (column + 1)));
+      c_chFont1608[chr][2 * column + 1] = (uint8_t)(0xFC ^ (chr << column));
+    }
+  }
+}
+
+ssd1306_handle_t ssd1306_create(i2c_port_t port, const uint16_t dev_addr) {
+  // display off, clocks, multiplex, offset, charge pump, addressing,
+  // remapping, COM pins, contrast, pre-charge, VCOMH, display on
+  static const uint8_t init[] = {0x00, 0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3,
+                                 0x00, 0x40, 0x8D, 0x14, 0x20, 0x02, 0xA1,
+                                 0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1,
+                                 0xDB, 0x40, 0xA4, 0xA6, 0xAF};
+
+  generate_fonts();
+  panel = (Ssd1306Model){.present = true,
+                         .address = dev_addr,
+                         .mode = ADDRESSING_PAGE,
+                         .column_end = HOST_SSD1306_WIDTH - 1,
+                         .page_end = HOST_SSD1306_PAGES - 1};
+
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (dev_addr << 1) | I2C_MASTER_WRITE, true);
+  i2c_master_write(cmd, init, sizeof(init), true);
+  i2c_master_stop(cmd);
+  esp_err_t ret = i2c_master_cmd_begin(port, cmd, 0);
+  i2c_cmd_link_delete(cmd);
+  if (ret != ESP_OK) {
+    fprintf(stderr, "ERROR: SSD1306 initialization failed\n");
+    return NULL;
+  }
+  return &panel;
+}
@@ -0,0 +1,432 @@
+/* schedgen: static schedule tables for Assignment 3.
+ *
+ * Places the task set of main.c (or the periodic tasks given with -t next
+ * to its server) onto the partitions with partition_task_set, like the
+ * admission of main.c, and simulates every partition with EDF or RM on the
+ * execution times of its tasks. The dispatch decisions over a hyperperiod
+ * are written as schedule_table.c, see schedule_table.h. A task that misses
+ * its deadline, or a job that is still pending at the next release of its
+ * task, fails the generation.
+ *
+ * With phases, the schedule repeats from the largest phase plus one or two
+ * hyperperiods at the latest; the decisions before that become the part of
+ * the table that runs once. */
+
+#include "partition.h"
+#include "schedule_table.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCHEDGEN_MAX_TASKS 16
+#define SCHEDGEN_MAX_ENTRIES 65536
+#define SNAPSHOTS 3
+
+// the task set of main.c
+extern PeriodicTaskParams task1_params, task2_params, task3_params, ps_params;
+
+typedef enum { POLICY_EDF, POLICY_RM } Policy;
+static const char *const policy_names[] = {"EDF", "RM"};
+static const char *const type_names[] = {
+    "PERIODIC_TASK", "PERIODIC_SERVER", "SPORADIC_SERVER",
+    "TOTAL_BANDWIDTH_SERVER", "CONSTANT_BANDWIDTH_SERVER", "SLACK_STEALER"};
+
+typedef struct {
+  uint64_t start_ms;
+  uint8_t task;
+} Segment;
+
+// state of the simulated tasks, relative to the time it was taken
+typedef struct {
+  uint64_t remaining[SCHEDGEN_MAX_TASKS];
+  uint64_t to_deadline[SCHEDGEN_MAX_TASKS];
+  uint64_t to_release[SCHEDGEN_MAX_TASKS];
+} Snapshot;
+
+static PeriodicTaskParams custom_params[SCHEDGEN_MAX_TASKS];
+
+static uint64_t gcd(uint64_t a, uint64_t b) {
+  while (b != 0) {
+    uint64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+// the job of task 'i' runs before the one of 'j'
+static bool runs_before(Policy policy, PeriodicTaskParams **tasks,
+                        const uint64_t *deadlines, unsigned int i,
+                        unsigned int j) {
+  if (policy == POLICY_EDF)
+    return deadlines[i] < deadlines[j];
+  return tasks[i]->period < tasks[j]->period;
+}
+
+/* Simulate 'tasks' until the last snapshot time and record the decisions
+ * into 'segments'. A new segment starts at every snapshot time, the state
+ * at these is stored in 'snapshots'. Returns the number of segments, 0 on
+ * a failure. */
+static unsigned int simulate(PeriodicTaskParams **tasks, unsigned int count,
+                             Policy policy, const uint64_t *snapshot_ms,
+                             Snapshot *snapshots, Segment *segments) {
+  uint64_t remaining[SCHEDGEN_MAX_TASKS] = {0};
+  uint64_t deadlines[SCHEDGEN_MAX_TASKS] = {0};
+  uint64_t releases[SCHEDGEN_MAX_TASKS];
+  unsigned int segment_count = 0, snapshot = 0;
+  uint64_t t = 0;
+
+  for (unsigned int i = 0; i < count; i++)
+    releases[i] = tasks[i]->release_time;
+  while (true) {
+    if (t == snapshot_ms[snapshot]) {
+      for (unsigned int i = 0; i < count; i++) {
+        snapshots[snapshot].remaining[i] = remaining[i];
+        snapshots[snapshot].to_deadline[i] =
+            remaining[i] > 0 ? deadlines[i] - t : 0;
+        snapshots[snapshot].to_release[i] = releases[i] - t;
+      }
+      if (++snapshot == SNAPSHOTS)
+        return segment_count;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+      if (releases[i] > t)
+        continue;
+      if (remaining[i] > 0) {
+        fprintf(stderr, "ERROR: Task %d is still pending at %llu ms\n",
+                tasks[i]->id, (unsigned long long)t);
+        return 0;
+      }
+      remaining[i] = tasks[i]->execution_time;
+      deadlines[i] = releases[i] + tasks[i]->deadline;
+      releases[i] += tasks[i]->period;
+    }
+
+    unsigned int running = count;
+    for (unsigned int i = 0; i < count; i++) {
+      if (remaining[i] > 0 &&
+          (running == count ||
+           runs_before(policy, tasks, deadlines, i, running)))
+        running = i;
+    }
+    uint64_t next_ms = snapshot_ms[snapshot];
+    for (unsigned int i = 0; i < count; i++) {
+      if (releases[i] < next_ms)
+        next_ms = releases[i];
+    }
+    if (running < count && t + remaining[running] < next_ms)
+      next_ms = t + remaining[running];
+
+    uint8_t task = running < count ? running : SCHEDULE_IDLE;
+    if (segment_count == 0 || segments[segment_count - 1].task != task ||
+        t == snapshot_ms[snapshot - (snapshot > 0)]) {
+      if (segment_count == SCHEDGEN_MAX_ENTRIES) {
+        fprintf(stderr, "ERROR: More than %d dispatch decisions\n",
+                SCHEDGEN_MAX_ENTRIES);
+        return 0;
+      }
+      segments[segment_count++] = (Segment){t, task};
+    }
+    if (running < count) {
+      remaining[running] -= next_ms - t;
+      if (remaining[running] == 0 && next_ms > deadlines[running]) {
+        fprintf(stderr, "ERROR: Task %d misses its deadline at %llu ms\n",
+                tasks[running]->id, (unsigned long long)deadlines[running]);
+        return 0;
+      }
+    }
+    for (unsigned int i = 0; i < count; i++) {
+      if (remaining[i] > 0 && deadlines[i] < next_ms) {
+        fprintf(stderr, "ERROR: Task %d misses its deadline at %llu ms\n",
+                tasks[i]->id, (unsigned long long)deadlines[i]);
+        return 0;
+      }
+    }
+    t = next_ms;
+  }
+}
+
+/* Write the table of one partition. Returns false if the schedule cannot
+ * be generated. */
+static bool write_table(FILE *out, unsigned int partition,
+                        PeriodicTaskParams **tasks, unsigned int count,
+                        Policy policy, unsigned int *number_of_entries,
+                        unsigned int *cycle_entry, uint64_t *cycle_start_ms,
+                        uint64_t *hyperperiod_ms) {
+  uint64_t hyperperiod = 1, phase = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    hyperperiod = hyperperiod / gcd(hyperperiod, tasks[i]->period) *
+                  tasks[i]->period;
+    if (tasks[i]->release_time > phase)
+      phase = tasks[i]->release_time;
+    if (hyperperiod + phase > UINT32_MAX / 3) {
+      fprintf(stderr, "ERROR: Hyperperiod of partition %u is too long\n",
+              partition);
+      return false;
+    }
+  }
+
+  uint64_t snapshot_ms[SNAPSHOTS] = {phase, phase + hyperperiod,
+                                     phase + 2 * hyperperiod};
+  Snapshot snapshots[SNAPSHOTS] = {0};
+  Segment *segments = malloc(SCHEDGEN_MAX_ENTRIES * sizeof(Segment));
+  if (segments == NULL) {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    return false;
+  }
+  unsigned int segment_count =
+      simulate(tasks, count, policy, snapshot_ms, snapshots, segments);
+  if (segment_count == 0) {
+    free(segments);
+    return false;
+  }
+  // the schedule repeats once the state does
+  uint64_t cycle_start;
+  if (memcmp(&snapshots[0], &snapshots[1], sizeof(Snapshot)) == 0) {
+    cycle_start = snapshot_ms[0];
+  } else if (memcmp(&snapshots[1], &snapshots[2], sizeof(Snapshot)) == 0) {
+    cycle_start = snapshot_ms[1];
+  } else {
+    fprintf(stderr, "ERROR: Schedule of partition %u does not repeat\n",
+            partition);
+    free(segments);
+    return false;
+  }
+
+  fprintf(out, "\n// partition %u: %s over %llu ms\n", partition,
+          policy_names[policy], (unsigned long long)hyperperiod);
+  fprintf(out, "static const ScheduleTask partition%u_tasks[] = {\n",
+          partition);
+  for (unsigned int i = 0; i < count; i++)
+    fprintf(out,
+            "    {.id = %d, .release_time = %lu, .execution_time = %lu, "
+            ".period = %lu,\n     .deadline = %lu, .type = %s},\n",
+            tasks[i]->id, tasks[i]->release_time, tasks[i]->execution_time,
+            tasks[i]->period, tasks[i]->deadline, type_names[tasks[i]->type]);
+  fprintf(out, "};\nstatic const ScheduleEntry partition%u_entries[] = {",
+          partition);
+  unsigned int entries = 0;
+  int last_task = -1;
+  for (unsigned int i = 0; i < segment_count; i++) {
+    Segment *segment = &segments[i];
+    if (segment->start_ms >= cycle_start + hyperperiod)
+      break;
+    if (segment->task == last_task && segment->start_ms != cycle_start)
+      continue;
+    if (segment->start_ms == cycle_start)
+      *cycle_entry = entries;
+    if (entries % 4 == 0)
+      fprintf(out, "\n   ");
+    if (segment->task == SCHEDULE_IDLE)
+      fprintf(out, " {%llu, SCHEDULE_IDLE},",
+              (unsigned long long)segment->start_ms);
+    else
+      fprintf(out, " {%llu, %u},", (unsigned long long)segment->start_ms,
+              segment->task);
+    last_task = segment->task;
+    entries++;
+  }
+  fprintf(out, "\n};\n");
+  free(segments);
+
+  *number_of_entries = entries;
+  *cycle_start_ms = cycle_start;
+  *hyperperiod_ms = hyperperiod;
+  return true;
+}
+
+// "C:T[:D[:phase]],..." in milliseconds
+static unsigned int parse_tasks(char *list) {
+  unsigned int count = 0;
+  for (char *item = strtok(list, ","); item != NULL;
+       item = strtok(NULL, ",")) {
+    unsigned long execution_time, period, deadline, phase = 0;
+    int fields = sscanf(item, "%lu:%lu:%lu:%lu", &execution_time, &period,
+                        &deadline, &phase);
+    if (count == SCHEDGEN_MAX_TASKS - 1 || fields < 2 ||
+        execution_time == 0 || period == 0)
+      return 0;
+    custom_params[count] = (PeriodicTaskParams){
+        .id = count + 1,
+        .release_time = phase,
+        .execution_time = execution_time,
+        .period = period,
+        .deadline = fields >= 3 ? deadline : period,
+        .gpio = No_GPIO,
+        .type = PERIODIC_TASK,
+    };
+    count++;
+  }
+  return count;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -t C:T[:D[:P]],...  periodic tasks in ms with phase P instead "
+          "of those\n"
+          "                      of main.c, the server of main.c is kept\n"
+          "  -a POLICY           edf | rm (default edf)\n"
+          "  -c PARTITIONS       EDF partitions, one per core (default 2)\n"
+          "  -p HEURISTIC        first | worst fit (default worst)\n"
+          "  -o FILE             output instead of stdout, e.g.\n"
+          "                      \"Assignment 3/main/schedule_table.c\"\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  PeriodicTaskParams *task_set[SCHEDGEN_MAX_TASKS] = {
+      &task1_params, &task2_params, &task3_params};
+  unsigned int number_of_tasks = 3, partitions = 2;
+  Policy policy = POLICY_EDF;
+  PartitionHeuristic heuristic = PARTITION_WORST_FIT;
+  const char *output = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:a:c:p:o:h")) != -1) {
+    switch (opt) {
+    case 't':
+      number_of_tasks = parse_tasks(optarg);
+      if (number_of_tasks == 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      for (unsigned int i = 0; i < number_of_tasks; i++)
+        task_set[i] = &custom_params[i];
+      break;
+    case 'a':
+      if (strcmp(optarg, "edf") == 0) {
+        policy = POLICY_EDF;
+      } else if (strcmp(optarg, "rm") == 0) {
+        policy = POLICY_RM;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'c':
+      partitions = strtoul(optarg, NULL, 10);
+      break;
+    case 'p':
+      if (strcmp(optarg, "first") == 0) {
+        heuristic = PARTITION_FIRST_FIT;
+      } else if (strcmp(optarg, "worst") == 0) {
+        heuristic = PARTITION_WORST_FIT;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (partitions == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  task_set[number_of_tasks++] = &ps_params;
+
+  // bandwidth servers are released by aperiodic jobs, not by the table
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    if (IS_BANDWIDTH_SERVER(task_set[i]->type)) {
+      fprintf(stderr, "ERROR: Task %d is a bandwidth server\n",
+              task_set[i]->id);
+      return EXIT_FAILURE;
+    }
+  }
+  AcceptanceTestResult results[SCHEDGEN_MAX_TASKS];
+  if (!partition_task_set(task_set, number_of_tasks, partitions, heuristic,
+                          results)) {
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      if (!results[i].accepted)
+        fprintf(stderr, "ERROR: Task %d does not fit into a partition\n",
+                task_set[i]->id);
+    }
+    return EXIT_FAILURE;
+  }
+
+  // the table goes to a temporary file first, so that a failed generation
+  // leaves the existing output alone
+  char temporary[FILENAME_MAX];
+  FILE *out;
+  if (output != NULL) {
+    if (snprintf(temporary, sizeof(temporary), "%s.tmp", output) >=
+        (int)sizeof(temporary)) {
+      fprintf(stderr, "ERROR: Output path %s is too long\n", output);
+      return EXIT_FAILURE;
+    }
+    out = fopen(temporary, "w");
+  } else {
+    out = tmpfile();
+  }
+  if (out == NULL) {
+    perror(output != NULL ? temporary : "tmpfile");
+    return EXIT_FAILURE;
+  }
+  fprintf(out,
+          "/* Generated by schedgen (Host/schedgen): %s, %u partition(s), "
+          "%s fit.\n * Regenerate instead of editing, see schedule_table.h. "
+          "*/\n\n#include \"schedule_table.h\"\n",
+          policy_names[policy], partitions,
+          heuristic == PARTITION_FIRST_FIT ? "first" : "worst");
+
+  unsigned int tables = 0;
+  unsigned int table_tasks[SCHEDGEN_MAX_TASKS];
+  unsigned int table_partition[SCHEDGEN_MAX_TASKS];
+  unsigned int number_of_entries[SCHEDGEN_MAX_TASKS];
+  unsigned int cycle_entry[SCHEDGEN_MAX_TASKS];
+  uint64_t cycle_start[SCHEDGEN_MAX_TASKS], hyperperiod[SCHEDGEN_MAX_TASKS];
+  for (unsigned int partition = 0; partition < partitions; partition++) {
+    PeriodicTaskParams *tasks[SCHEDGEN_MAX_TASKS];
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      if (task_set[i]->partition == partition)
+        tasks[count++] = task_set[i];
+    }
+    if (count == 0)
+      continue;
+    if (!write_table(out, partition, tasks, count, policy,
+                     &number_of_entries[tables], &cycle_entry[tables],
+                     &cycle_start[tables], &hyperperiod[tables])) {
+      fclose(out);
+      if (output != NULL)
+        remove(temporary);
+      return EXIT_FAILURE;
+    }
+    table_tasks[tables] = count;
+    table_partition[tables++] = partition;
+  }
+
+  fprintf(out, "\nconst ScheduleTable schedule_tables[] = {\n");
+  for (unsigned int i = 0; i < tables; i++)
+    fprintf(out,
+            "    {partition%u_tasks, %u, partition%u_entries, %u, %u, %llu, "
+            "%llu},\n",
+            table_partition[i], table_tasks[i], table_partition[i],
+            number_of_entries[i], cycle_entry[i],
+            (unsigned long long)cycle_start[i],
+            (unsigned long long)hyperperiod[i]);
+  fprintf(out, "};\nconst unsigned int number_of_schedule_tables = %u;\n",
+          tables);
+  if (output == NULL) {
+    rewind(out);
+    int c;
+    while ((c = fgetc(out)) != EOF)
+      putchar(c);
+    fclose(out);
+    return EXIT_SUCCESS;
+  }
+  if (fclose(out) != 0 || rename(temporary, output) != 0) {
+    perror(output);
+    remove(temporary);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
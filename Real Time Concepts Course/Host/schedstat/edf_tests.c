@@ -0,0 +1,89 @@
+#include "edf.h"
+#include "global.h"
+#include "partition.h"
+#include "tests.h"
+
+struct EDFWorkspace {
+  PeriodicTaskParams *params;
+  PeriodicTaskParams **task_set;
+  AcceptanceTestResult *results;
+  unsigned int partitions;
+};
+
+EDFWorkspace *edf_workspace_create(unsigned int max_tasks,
+                                   unsigned int partitions) {
+  EDFWorkspace *workspace = malloc(sizeof(EDFWorkspace));
+  if (workspace == NULL)
+    return NULL;
+  workspace->partitions = partitions;
+  workspace->params = calloc(max_tasks, sizeof(PeriodicTaskParams));
+  workspace->task_set = calloc(max_tasks, sizeof(PeriodicTaskParams *));
+  workspace->results = calloc(max_tasks, sizeof(AcceptanceTestResult));
+  if (workspace->params == NULL || workspace->task_set == NULL ||
+      workspace->results == NULL) {
+    edf_workspace_destroy(workspace);
+    return NULL;
+  }
+  for (unsigned int i = 0; i < max_tasks; i++) {
+    workspace->task_set[i] = &workspace->params[i];
+  }
+  return workspace;
+}
+
+void edf_workspace_destroy(EDFWorkspace *workspace) {
+  free(workspace->params);
+  free(workspace->task_set);
+  free(workspace->results);
+  free(workspace);
+}
+
+bool edf_test_run(EDFWorkspace *workspace, TestId test, const SetTask *tasks,
+                  unsigned int number_of_tasks) {
+  for (TaskId i = 0; i < number_of_tasks; i++) {
+    // the partitioning sorts the table
+    workspace->task_set[i] = &workspace->params[i];
+    workspace->params[i].id = (char)i;
+    workspace->params[i].execution_time = tasks[i].execution_time;
+    workspace->params[i].period = tasks[i].period;
+    workspace->params[i].deadline = tasks[i].deadline;
+    workspace->params[i].type = PERIODIC_TASK;
+  }
+
+  // tests of the whole set, which is checked at once
+  if (test == TEST_QPA || test == TEST_GFB || test == TEST_BCL ||
+      test == TEST_BAK) {
+    TaskId last = number_of_tasks - 1;
+    for (TaskId i = 0; i < number_of_tasks; i++) {
+      workspace->results[i] = default_result;
+      workspace->results[i].accepted = true;
+    }
+    if (test == TEST_QPA)
+      processor_demand_test(workspace->task_set, last, workspace->results);
+    else if (test == TEST_GFB)
+      gfb_test(workspace->task_set, last, workspace->results,
+               workspace->partitions);
+    else if (test == TEST_BCL)
+      bcl_test(workspace->task_set, last, workspace->results,
+               workspace->partitions);
+    else
+      bak_test(workspace->task_set, last, workspace->results,
+               workspace->partitions);
+    return workspace->results[last].accepted;
+  }
+  if (test == TEST_PFFD || test == TEST_PWFD)
+    return partition_task_set(
+        workspace->task_set, number_of_tasks, workspace->partitions,
+        test == TEST_PFFD ? PARTITION_FIRST_FIT : PARTITION_WORST_FIT,
+        workspace->results);
+  if (test != TEST_DENSITY)
+    return false;
+
+  // all previously admitted tasks have to stay admitted
+  for (TaskId i = 0; i < number_of_tasks; i++) {
+    workspace->results[i] = default_result;
+    system_density_test_int(workspace->task_set, i, workspace->results);
+    if (!workspace->results[i].accepted)
+      return false;
+  }
+  return true;
+}
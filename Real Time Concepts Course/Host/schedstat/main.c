@@ -0,0 +1,329 @@
+/* schedstat: batch schedulability analysis on the host.
+ *
+ * Generates random task sets for a range of total utilizations and reports
+ * which fraction of them is accepted by each schedulability test of
+ * Assignment 2 (RMS) and Assignment 3 (EDF), together with the average cost
+ * of each test per task set. The partitioned and global EDF tests run every
+ * set on a given number of simulated cores. The sets are spread over all
+ * cores of the host with a work-stealing pool. Every set is seeded from
+ * (seed, utilization, index), so the results do not depend on the number of
+ * threads. */
+
+#include "pool.h"
+#include "taskset.h"
+#include "tests.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SETS_PER_ITEM 256
+
+const char *const test_names[NUMBER_OF_TESTS] = {
+    "UB",   "HB",    "WCS",   "TDA",   "ACC",   "RTA",   "SIM",
+    "DENS", "QPA",   "P-FFD", "P-WFD", "G-GFB", "G-BCL", "G-BAK"};
+
+/* Pairs of a sufficient test and an exact test for the same model. A set
+ * that the first one accepts and the second one rejects is a bug in one of
+ * them, and makes schedstat fail. */
+static const TestId dominance[][2] = {{TEST_DENSITY, TEST_QPA}};
+#define NUMBER_OF_DOMINANCES (sizeof(dominance) / sizeof(dominance[0]))
+
+typedef struct {
+  unsigned long generated;
+  unsigned long accepted[NUMBER_OF_TESTS];
+  unsigned long long nanoseconds[NUMBER_OF_TESTS];
+  unsigned long violations[NUMBER_OF_DOMINANCES];
+} PointStats;
+
+typedef struct {
+  RMWorkspace *rm;
+  EDFWorkspace *edf;
+  SetTask *tasks;
+  PointStats *stats; // one entry per utilization point
+} WorkerState;
+
+typedef struct {
+  TaskSetConfig config;
+  unsigned long sets;
+  double *utilizations;
+  unsigned int points;
+  unsigned long long seed;
+  WorkerState *workers;
+} Experiment;
+
+static unsigned long long now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void run_item(unsigned int worker, size_t item, void *context) {
+  Experiment *experiment = context;
+  WorkerState *state = &experiment->workers[worker];
+  size_t items_per_point =
+      (experiment->sets + SETS_PER_ITEM - 1) / SETS_PER_ITEM;
+  unsigned int point = item / items_per_point;
+  unsigned long first = (item % items_per_point) * SETS_PER_ITEM;
+  unsigned long last = first + SETS_PER_ITEM;
+  if (last > experiment->sets)
+    last = experiment->sets;
+
+  PointStats *stats = &state->stats[point];
+  unsigned int n = experiment->config.number_of_tasks;
+  for (unsigned long set = first; set < last; set++) {
+    Rng rng;
+    rng_seed(&rng, experiment->seed ^ ((unsigned long long)point << 40) ^ set);
+    if (!taskset_generate(&experiment->config,
+                          experiment->utilizations[point], &rng,
+                          state->tasks))
+      continue;
+
+    bool accepted[NUMBER_OF_TESTS];
+    stats->generated++;
+    for (TestId test = 0; test < NUMBER_OF_TESTS; test++) {
+      unsigned long long start = now_ns();
+      accepted[test] = test >= TEST_DENSITY
+                           ? edf_test_run(state->edf, test, state->tasks, n)
+                           : rm_test_run(state->rm, test, state->tasks, n);
+      stats->nanoseconds[test] += now_ns() - start;
+      stats->accepted[test] += accepted[test];
+    }
+    for (unsigned int i = 0; i < NUMBER_OF_DOMINANCES; i++) {
+      stats->violations[i] +=
+          accepted[dominance[i][0]] && !accepted[dominance[i][1]];
+    }
+  }
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -n TASKS        tasks per set (default 8)\n"
+          "  -s SETS         sets per utilization point (default 100000)\n"
+          "  -u MIN:MAX:STEP total utilization range (default 0.05:1.0:0.05)\n"
+          "  -c CORES        simulated cores of the partitioned (P-) and\n"
+          "                  global (G-) EDF tests (default 1)\n"
+          "  -g GENERATOR    uunifast | uunifast-discard (default\n"
+          "                  uunifast-discard)\n"
+          "  -p DIST         uniform | loguniform | harmonic | prime\n"
+          "                  (default loguniform)\n"
+          "  -P MIN:MAX      period range in ticks (default 10:1000)\n"
+          "  -d MIN:MAX      deadline/period ratio range (default 1:1)\n"
+          "  -j THREADS      worker threads (default: all cores)\n"
+          "  -S SEED         random seed (default 1)\n"
+          "  -H TICKS        longest schedule simulated by SIM, longer ones\n"
+          "                  count as rejected (default 100000)\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  TaskSetConfig config = {.number_of_tasks = 8,
+                          .generator = GENERATOR_UUNIFAST_DISCARD,
+                          .periods = PERIODS_LOG_UNIFORM,
+                          .period_min = 10,
+                          .period_max = 1000,
+                          .deadline_min = 1.0,
+                          .deadline_max = 1.0};
+  double u_min = 0.05, u_max = 1.0, u_step = 0.05;
+  unsigned long sets = 100000;
+  unsigned long long seed = 1;
+  unsigned long long simulation_horizon = 100000;
+  unsigned int cores = 1;
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:s:u:c:g:p:P:d:j:S:H:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      config.number_of_tasks = strtoul(optarg, NULL, 10);
+      break;
+    case 's':
+      sets = strtoul(optarg, NULL, 10);
+      break;
+    case 'u':
+      if (sscanf(optarg, "%lf:%lf:%lf", &u_min, &u_max, &u_step) != 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'c':
+      cores = strtoul(optarg, NULL, 10);
+      break;
+    case 'g':
+      if (strcmp(optarg, "uunifast") == 0) {
+        config.generator = GENERATOR_UUNIFAST;
+      } else if (strcmp(optarg, "uunifast-discard") == 0) {
+        config.generator = GENERATOR_UUNIFAST_DISCARD;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'p':
+      if (strcmp(optarg, "uniform") == 0) {
+        config.periods = PERIODS_UNIFORM;
+      } else if (strcmp(optarg, "loguniform") == 0) {
+        config.periods = PERIODS_LOG_UNIFORM;
+      } else if (strcmp(optarg, "harmonic") == 0) {
+        config.periods = PERIODS_HARMONIC;
+      } else if (strcmp(optarg, "prime") == 0) {
+        config.periods = PERIODS_PRIME;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'P':
+      if (sscanf(optarg, "%lu:%lu", &config.period_min, &config.period_max) !=
+          2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'd':
+      if (sscanf(optarg, "%lf:%lf", &config.deadline_min,
+                 &config.deadline_max) != 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'j':
+      threads = strtol(optarg, NULL, 10);
+      break;
+    case 'S':
+      seed = strtoull(optarg, NULL, 10);
+      break;
+    case 'H':
+      simulation_horizon = strtoull(optarg, NULL, 10);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  if (config.number_of_tasks == 0 || sets == 0 || u_step <= 0 ||
+      u_min > u_max || config.period_min == 0 ||
+      config.period_min > config.period_max ||
+      config.deadline_min > config.deadline_max || threads < 1 ||
+      cores == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Experiment experiment = {.config = config, .sets = sets, .seed = seed};
+  experiment.points = (unsigned int)((u_max - u_min) / u_step + 1.5);
+  experiment.utilizations = calloc(experiment.points, sizeof(double));
+  experiment.workers = calloc(threads, sizeof(WorkerState));
+  if (experiment.utilizations == NULL || experiment.workers == NULL) {
+    fprintf(stderr, "ERROR: Memory allocation failed\n");
+    return EXIT_FAILURE;
+  }
+  for (unsigned int p = 0; p < experiment.points; p++) {
+    experiment.utilizations[p] = u_min + p * u_step;
+  }
+  for (long w = 0; w < threads; w++) {
+    WorkerState *state = &experiment.workers[w];
+    state->rm = rm_workspace_create(config.number_of_tasks,
+                                    simulation_horizon);
+    state->edf = edf_workspace_create(config.number_of_tasks, cores);
+    state->tasks = calloc(config.number_of_tasks, sizeof(SetTask));
+    state->stats = calloc(experiment.points, sizeof(PointStats));
+    if (state->rm == NULL || state->edf == NULL || state->tasks == NULL ||
+        state->stats == NULL) {
+      fprintf(stderr, "ERROR: Memory allocation failed\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  size_t items_per_point = (sets + SETS_PER_ITEM - 1) / SETS_PER_ITEM;
+  unsigned long long start = now_ns();
+  pool_run(threads, items_per_point * experiment.points, run_item,
+           &experiment);
+  double elapsed = (now_ns() - start) / 1e9;
+
+  static const char *const generators[] = {"uunifast", "uunifast-discard"};
+  static const char *const distributions[] = {"uniform", "loguniform",
+                                              "harmonic", "prime"};
+  printf("# schedstat: n=%u sets=%lu generator=%s periods=%s[%lu,%lu] "
+         "deadlines=[%.2f,%.2f]T cores=%u threads=%ld seed=%llu\n",
+         config.number_of_tasks, sets, generators[config.generator],
+         distributions[config.periods], config.period_min, config.period_max,
+         config.deadline_min, config.deadline_max, cores, threads, seed);
+  printf("# acceptance ratio per test\n");
+  printf("%6s %9s", "U", "sets");
+  for (TestId test = 0; test < NUMBER_OF_TESTS; test++)
+    printf(" %7s", test_names[test]);
+  printf("\n");
+
+  PointStats total = {0};
+  for (unsigned int p = 0; p < experiment.points; p++) {
+    PointStats point = {0};
+    for (long w = 0; w < threads; w++) {
+      PointStats *stats = &experiment.workers[w].stats[p];
+      point.generated += stats->generated;
+      for (TestId test = 0; test < NUMBER_OF_TESTS; test++) {
+        point.accepted[test] += stats->accepted[test];
+        point.nanoseconds[test] += stats->nanoseconds[test];
+      }
+      for (unsigned int i = 0; i < NUMBER_OF_DOMINANCES; i++)
+        total.violations[i] += stats->violations[i];
+    }
+    printf("%6.3f %9lu", experiment.utilizations[p], point.generated);
+    for (TestId test = 0; test < NUMBER_OF_TESTS; test++) {
+      printf(" %7.4f", point.generated
+                           ? (double)point.accepted[test] / point.generated
+                           : 0.0);
+      total.nanoseconds[test] += point.nanoseconds[test];
+    }
+    printf("\n");
+    total.generated += point.generated;
+  }
+
+  printf("# average cost per set in ns\n%6s %9lu", "-", total.generated);
+  for (TestId test = 0; test < NUMBER_OF_TESTS; test++) {
+    printf(" %7.0f", total.generated
+                         ? (double)total.nanoseconds[test] / total.generated
+                         : 0.0);
+  }
+  printf("\n");
+
+  // which stage of acceptance_test decided, over all tasks it analysed
+  unsigned long decisions = 0;
+  for (unsigned int stage = 0; stage < rm_stage_count(); stage++) {
+    for (long w = 0; w < threads; w++)
+      decisions += rm_stage_hits(experiment.workers[w].rm, stage);
+  }
+  printf("# acceptance_test decisions per stage\n");
+  for (unsigned int stage = 0; stage < rm_stage_count(); stage++) {
+    unsigned long hits = 0;
+    for (long w = 0; w < threads; w++)
+      hits += rm_stage_hits(experiment.workers[w].rm, stage);
+    printf("# %-9s %12lu (%6.2f%%)\n", rm_stage_name(stage), hits,
+           decisions ? 100.0 * hits / decisions : 0.0);
+  }
+  printf("# %lu sets in %.2f s\n", total.generated, elapsed);
+
+  int status = EXIT_SUCCESS;
+  for (unsigned int i = 0; i < NUMBER_OF_DOMINANCES; i++) {
+    if (total.violations[i] == 0)
+      continue;
+    fprintf(stderr, "ERROR: %lu sets accepted by %s but rejected by %s\n",
+            total.violations[i], test_names[dominance[i][0]],
+            test_names[dominance[i][1]]);
+    status = EXIT_FAILURE;
+  }
+
+  for (long w = 0; w < threads; w++) {
+    rm_workspace_destroy(experiment.workers[w].rm);
+    edf_workspace_destroy(experiment.workers[w].edf);
+    free(experiment.workers[w].tasks);
+    free(experiment.workers[w].stats);
+  }
+  free(experiment.workers);
+  free(experiment.utilizations);
+  return status;
+}
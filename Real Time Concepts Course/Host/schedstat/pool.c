@@ -0,0 +1,104 @@
+#include "pool.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  pthread_mutex_t lock;
+  size_t front; // next item a thief takes
+  size_t back;  // one past the next item the owner takes
+} WorkQueue;
+
+typedef struct {
+  WorkQueue *queues;
+  unsigned int workers;
+  PoolJob job;
+  void *context;
+} Pool;
+
+typedef struct {
+  Pool *pool;
+  unsigned int id;
+} Worker;
+
+// Owner side: take the last item of its own queue
+static bool queue_pop(WorkQueue *queue, size_t *item) {
+  bool found = false;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->front < queue->back) {
+    *item = --queue->back;
+    found = true;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return found;
+}
+
+// Thief side: move the front half of a victim's queue into the own queue
+static bool queue_steal(Pool *pool, unsigned int thief) {
+  WorkQueue *own = &pool->queues[thief];
+  for (unsigned int offset = 1; offset < pool->workers; offset++) {
+    WorkQueue *victim = &pool->queues[(thief + offset) % pool->workers];
+    size_t front = 0, back = 0;
+
+    pthread_mutex_lock(&victim->lock);
+    size_t remaining = victim->back - victim->front;
+    if (remaining > 0) {
+      front = victim->front;
+      back = front + (remaining + 1) / 2;
+      victim->front = back;
+    }
+    pthread_mutex_unlock(&victim->lock);
+
+    if (back > front) {
+      pthread_mutex_lock(&own->lock);
+      own->front = front;
+      own->back = back;
+      pthread_mutex_unlock(&own->lock);
+      return true;
+    }
+  }
+  return false;
+}
+
+static void *worker_main(void *arg) {
+  Worker *worker = arg;
+  Pool *pool = worker->pool;
+  size_t item;
+
+  // no new items are created, so the pool is done once stealing fails
+  do {
+    while (queue_pop(&pool->queues[worker->id], &item))
+      pool->job(worker->id, item, pool->context);
+  } while (queue_steal(pool, worker->id));
+  return NULL;
+}
+
+void pool_run(unsigned int workers, size_t items, PoolJob job, void *context) {
+  Pool pool = {.workers = workers, .job = job, .context = context};
+  pool.queues = calloc(workers, sizeof(WorkQueue));
+  pthread_t *threads = calloc(workers, sizeof(pthread_t));
+  Worker *worker_args = calloc(workers, sizeof(Worker));
+  if (pool.queues == NULL || threads == NULL || worker_args == NULL) {
+    fprintf(stderr, "ERROR: Memory allocation for the worker pool failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (unsigned int w = 0; w < workers; w++) {
+    pthread_mutex_init(&pool.queues[w].lock, NULL);
+    pool.queues[w].front = items * w / workers;
+    pool.queues[w].back = items * (w + 1) / workers;
+  }
+  for (unsigned int w = 0; w < workers; w++) {
+    worker_args[w] = (Worker){.pool = &pool, .id = w};
+    pthread_create(&threads[w], NULL, worker_main, &worker_args[w]);
+  }
+  for (unsigned int w = 0; w < workers; w++) {
+    pthread_join(threads[w], NULL);
+    pthread_mutex_destroy(&pool.queues[w].lock);
+  }
+
+  free(worker_args);
+  free(threads);
+  free(pool.queues);
+}
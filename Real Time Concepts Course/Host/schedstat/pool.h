@@ -0,0 +1,14 @@
+#ifndef SCHEDSTAT_POOL_H
+#define SCHEDSTAT_POOL_H
+
+#include <stddef.h>
+
+typedef void (*PoolJob)(unsigned int worker, size_t item, void *context);
+
+/* Run 'job' for the items 0..items-1 on 'workers' threads. Every worker
+ * starts with a contiguous block of items and works through it from the
+ * back. Idle workers steal the front half of the remaining block of another
+ * worker. Returns when all items are done. */
+void pool_run(unsigned int workers, size_t items, PoolJob job, void *context);
+
+#endif
@@ -0,0 +1,115 @@
+#include "analysis.h"
+#include "rta.h"
+#include "simulation.h"
+#include "tests.h"
+
+struct RMWorkspace {
+  TaskParams *params;
+  TaskParams **task_set;
+  RTAResult *rta_results;
+  SimulationResult *simulation_results;
+  unsigned long long simulation_horizon;
+  unsigned long stage_hits[NUMBER_OF_STAGES];
+};
+
+RMWorkspace *rm_workspace_create(unsigned int max_tasks,
+                                 unsigned long long simulation_horizon) {
+  RMWorkspace *workspace = malloc(sizeof(RMWorkspace));
+  if (workspace == NULL)
+    return NULL;
+  workspace->simulation_horizon = simulation_horizon;
+  for (unsigned int i = 0; i < NUMBER_OF_STAGES; i++) {
+    workspace->stage_hits[i] = 0;
+  }
+  workspace->params = calloc(max_tasks, sizeof(TaskParams));
+  workspace->task_set = calloc(max_tasks, sizeof(TaskParams *));
+  workspace->rta_results = calloc(max_tasks, sizeof(RTAResult));
+  workspace->simulation_results = calloc(max_tasks, sizeof(SimulationResult));
+  if (workspace->params == NULL || workspace->task_set == NULL ||
+      workspace->rta_results == NULL ||
+      workspace->simulation_results == NULL) {
+    rm_workspace_destroy(workspace);
+    return NULL;
+  }
+  for (unsigned int i = 0; i < max_tasks; i++) {
+    workspace->task_set[i] = &workspace->params[i];
+  }
+  return workspace;
+}
+
+void rm_workspace_destroy(RMWorkspace *workspace) {
+  free(workspace->params);
+  free(workspace->task_set);
+  free(workspace->rta_results);
+  free(workspace->simulation_results);
+  free(workspace);
+}
+
+bool rm_test_run(RMWorkspace *workspace, TestId test, const SetTask *tasks,
+                 unsigned int number_of_tasks) {
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    workspace->params[i].id = (char)i;
+    workspace->params[i].execution_time = tasks[i].execution_time;
+    workspace->params[i].period = tasks[i].period;
+    workspace->params[i].deadline = tasks[i].deadline;
+  }
+
+  if (test == TEST_RTA) {
+    response_time_analysis(workspace->task_set, number_of_tasks,
+                           workspace->rta_results);
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      if (!workspace->rta_results[i].accepted)
+        return false;
+    }
+    return true;
+  }
+
+  if (test == TEST_SIM) {
+    if (!fixed_priority_simulation(workspace->task_set, number_of_tasks,
+                                   workspace->simulation_horizon,
+                                   workspace->simulation_results))
+      return false;
+    for (unsigned int i = 0; i < number_of_tasks; i++) {
+      if (!workspace->simulation_results[i].accepted)
+        return false;
+    }
+    return true;
+  }
+
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    AcceptanceTestResult result = default_result;
+    switch (test) {
+    case TEST_UB:
+      utilization_bound_test_int(workspace->task_set, i, &result);
+      break;
+    case TEST_HB:
+      hyperbolic_bound_test_int(workspace->task_set, i, &result);
+      break;
+    case TEST_WCS:
+      worst_case_simulation_int(workspace->task_set, i, &result);
+      break;
+    case TEST_TDA:
+      time_demand_analysis_int(workspace->task_set, i, &result);
+      break;
+    case TEST_ACCEPTANCE:
+      acceptance_test(workspace->task_set, i, &result);
+      workspace->stage_hits[result.stage]++;
+      break;
+    default:
+      return false;
+    }
+    if (!result.accepted)
+      return false;
+  }
+  return true;
+}
+
+unsigned int rm_stage_count(void) { return NUMBER_OF_STAGES; }
+
+const char *rm_stage_name(unsigned int stage) {
+  return acceptance_stage_names[stage];
+}
+
+unsigned long rm_stage_hits(RMWorkspace *workspace, unsigned int stage) {
+  return workspace->stage_hits[stage];
+}
@@ -0,0 +1,119 @@
+#include "taskset.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define MAX_DISCARD_ATTEMPTS 1000
+
+void rng_seed(Rng *rng, uint64_t seed) {
+  // splitmix64 to spread similar seeds over the state space
+  uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  rng->state = (z ^ (z >> 31)) | 1;
+}
+
+uint64_t rng_next(Rng *rng) {
+  rng->state ^= rng->state >> 12;
+  rng->state ^= rng->state << 25;
+  rng->state ^= rng->state >> 27;
+  return rng->state * 0x2545f4914f6cdd1dULL;
+}
+
+double rng_uniform(Rng *rng) { return (rng_next(rng) >> 11) * 0x1.0p-53; }
+
+// Bini & Buttazzo's UUniFast: unbiased utilizations summing up to 'total'
+static bool uunifast(unsigned int n, double total, Rng *rng,
+                     double *utilizations) {
+  bool valid = true;
+  double sum = total;
+  for (unsigned int i = 1; i < n; i++) {
+    double next = sum * pow(rng_uniform(rng), 1.0 / (n - i));
+    utilizations[i - 1] = sum - next;
+    valid &= utilizations[i - 1] <= 1.0;
+    sum = next;
+  }
+  utilizations[n - 1] = sum;
+  return valid && sum <= 1.0;
+}
+
+static bool is_prime(unsigned long x) {
+  if (x < 2)
+    return false;
+  for (unsigned long d = 2; d * d <= x; d++) {
+    if (x % d == 0)
+      return false;
+  }
+  return true;
+}
+
+// first prime from 'x' on, or the last one before it if there is none
+static unsigned long prime_near(unsigned long x, unsigned long min,
+                                unsigned long max) {
+  for (unsigned long p = x; p <= max; p++) {
+    if (is_prime(p))
+      return p;
+  }
+  for (unsigned long p = x; p > min; p--) {
+    if (is_prime(p - 1))
+      return p - 1;
+  }
+  return x;
+}
+
+static unsigned long draw_period(const TaskSetConfig *config, Rng *rng) {
+  double min = config->period_min, max = config->period_max;
+  switch (config->periods) {
+  case PERIODS_LOG_UNIFORM:
+    return (unsigned long)exp(log(min) +
+                              rng_uniform(rng) * (log(max + 1) - log(min)));
+  case PERIODS_HARMONIC: {
+    unsigned int powers = 0;
+    while ((config->period_min << (powers + 1)) <= config->period_max)
+      powers++;
+    return config->period_min << (rng_next(rng) % (powers + 1));
+  }
+  case PERIODS_PRIME:
+    return prime_near(config->period_min +
+                          rng_next(rng) %
+                              (config->period_max - config->period_min + 1),
+                      config->period_min, config->period_max);
+  case PERIODS_UNIFORM:
+  default:
+    return config->period_min +
+           rng_next(rng) % (config->period_max - config->period_min + 1);
+  }
+}
+
+static int compare_by_period(const void *a, const void *b) {
+  const SetTask *task_a = a, *task_b = b;
+  return (task_a->period > task_b->period) - (task_a->period < task_b->period);
+}
+
+bool taskset_generate(const TaskSetConfig *config, double utilization,
+                      Rng *rng, SetTask *tasks) {
+  unsigned int n = config->number_of_tasks;
+  double utilizations[n];
+
+  unsigned int attempts = 0;
+  while (!uunifast(n, utilization, rng, utilizations) &&
+         config->generator == GENERATOR_UUNIFAST_DISCARD) {
+    if (++attempts == MAX_DISCARD_ATTEMPTS)
+      return false;
+  }
+
+  for (unsigned int i = 0; i < n; i++) {
+    unsigned long period = draw_period(config, rng);
+    double ratio =
+        config->deadline_min +
+        rng_uniform(rng) * (config->deadline_max - config->deadline_min);
+    unsigned long execution_time = lround(utilizations[i] * period);
+    unsigned long deadline = lround(ratio * period);
+
+    tasks[i].period = period;
+    tasks[i].execution_time = execution_time > 0 ? execution_time : 1;
+    tasks[i].deadline = deadline > 0 ? deadline : 1;
+  }
+
+  qsort(tasks, n, sizeof(SetTask), compare_by_period);
+  return true;
+}
@@ -0,0 +1,53 @@
+#ifndef SCHEDSTAT_TASKSET_H
+#define SCHEDSTAT_TASKSET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Task of a generated task set. The set is ordered by period, i.e., index 0
+ * has the highest priority under RMS. Times are given in ticks. */
+typedef struct {
+  unsigned long execution_time;
+  unsigned long period;
+  unsigned long deadline;
+} SetTask;
+
+typedef enum {
+  PERIODS_UNIFORM,
+  PERIODS_LOG_UNIFORM,
+  PERIODS_HARMONIC,
+  PERIODS_PRIME, // distinct periods are coprime, their lcm grows fastest
+} PeriodDistribution;
+
+typedef enum {
+  GENERATOR_UUNIFAST,
+  GENERATOR_UUNIFAST_DISCARD,
+} Generator;
+
+typedef struct {
+  unsigned int number_of_tasks;
+  Generator generator;
+  PeriodDistribution periods;
+  unsigned long period_min;
+  unsigned long period_max;
+  double deadline_min; // relative deadline as a fraction of the period
+  double deadline_max;
+} TaskSetConfig;
+
+// xorshift64* generator, one per generated set for reproducible results
+typedef struct {
+  uint64_t state;
+} Rng;
+
+void rng_seed(Rng *rng, uint64_t seed);
+uint64_t rng_next(Rng *rng);
+double rng_uniform(Rng *rng); // [0, 1)
+
+/* Generate a task set with the given total utilization into 'tasks'
+ * (config->number_of_tasks entries). With UUniFast-Discard, sets containing
+ * a task with a utilization above 1 are drawn again; false is returned if no
+ * valid set was found after a bounded number of attempts. */
+bool taskset_generate(const TaskSetConfig *config, double utilization,
+                      Rng *rng, SetTask *tasks);
+
+#endif
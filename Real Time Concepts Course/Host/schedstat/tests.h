@@ -0,0 +1,56 @@
+#ifndef SCHEDSTAT_TESTS_H
+#define SCHEDSTAT_TESTS_H
+
+#include "taskset.h"
+#include <stdbool.h>
+
+/* Wrappers around the schedulability tests of the assignments. The RMS tests
+ * of Assignment 2 and the EDF tests of Assignment 3 use different headers
+ * with clashing type names, so each lives in its own translation unit behind
+ * an opaque workspace. A set is accepted by a per-task test if every task of
+ * the set is accepted. */
+
+typedef enum {
+  TEST_UB,         // utilization_bound_test_int
+  TEST_HB,         // hyperbolic_bound_test_int
+  TEST_WCS,        // worst_case_simulation_int
+  TEST_TDA,        // time_demand_analysis_int
+  TEST_ACCEPTANCE, // acceptance_test
+  TEST_RTA,        // response_time_analysis
+  TEST_SIM,        // fixed_priority_simulation (inconclusive = rejected)
+  TEST_DENSITY,    // system_density_test_int (EDF)
+  TEST_QPA,        // processor_demand_test (EDF)
+  TEST_PFFD,       // partition_task_set, first-fit decreasing (EDF)
+  TEST_PWFD,       // partition_task_set, worst-fit decreasing (EDF)
+  TEST_GFB,        // gfb_test, global EDF
+  TEST_BCL,        // bcl_test, global EDF
+  TEST_BAK,        // bak_test, global EDF
+  NUMBER_OF_TESTS
+} TestId;
+
+extern const char *const test_names[NUMBER_OF_TESTS];
+
+typedef struct RMWorkspace RMWorkspace;
+RMWorkspace *rm_workspace_create(unsigned int max_tasks,
+                                 unsigned long long simulation_horizon);
+void rm_workspace_destroy(RMWorkspace *workspace);
+bool rm_test_run(RMWorkspace *workspace, TestId test, const SetTask *tasks,
+                 unsigned int number_of_tasks);
+
+/* Number of tasks decided by each stage of acceptance_test, summed over all
+ * TEST_ACCEPTANCE runs of the workspace. */
+unsigned int rm_stage_count(void);
+const char *rm_stage_name(unsigned int stage);
+unsigned long rm_stage_hits(RMWorkspace *workspace, unsigned int stage);
+
+/* The partitioned EDF tests place the set onto 'partitions' simulated
+ * cores, each with its own system density test. The global EDF tests run it
+ * on as many cores. */
+typedef struct EDFWorkspace EDFWorkspace;
+EDFWorkspace *edf_workspace_create(unsigned int max_tasks,
+                                   unsigned int partitions);
+void edf_workspace_destroy(EDFWorkspace *workspace);
+bool edf_test_run(EDFWorkspace *workspace, TestId test, const SetTask *tasks,
+                  unsigned int number_of_tasks);
+
+#endif
@@ -0,0 +1,24 @@
+#include "display_server.h"
+
+/* The simulation does not render: drawing takes no virtual time, and the
+ * panel content is not what it is about. Posts are only counted. */
+
+static bool started = false;
+static DisplayServerStats stats;
+
+bool display_server_start(DisplayRenderFunction render_function,
+                          size_t snapshot_size, UBaseType_t priority,
+                          TickType_t frame_interval) {
+  started = true;
+  stats = (DisplayServerStats){0, 0, 0};
+  return true;
+}
+
+bool display_server_post(const void *snapshot) {
+  if (!started)
+    return false;
+  stats.posted++;
+  return true;
+}
+
+DisplayServerStats display_server_stats() { return stats; }
@@ -0,0 +1,338 @@
+/* edfsim: the EDF scheduler of Assignment 3 in the discrete-event
+ * simulation of sim.h.
+ *
+ * Runs the unchanged scheduler, admission control, periodic tasks and
+ * aperiodic server of Assignment 3 for a span of virtual time, which takes
+ * a fraction of that on the host. The task set is the one of main.c, or
+ * the periodic tasks given with -t next to its server. Every job of a task
+ * lasts from the notification that releases it until the task reports its
+ * completion; its response time is checked against the deadline. The
+ * button is pressed at exponentially distributed intervals. With -T, the
+ * partitions whose tasks match a table of schedule_table.c dispatch from
+ * it. -A swaps the server of main.c, e.g., for the slack stealer. The
+ * device has portNUM_PROCESSORS cores, set by EDFSIM_CORES of
+ * CMakeLists.txt, and -m picks partitioned or global EDF. A job that
+ * overruns its period makes the scheduler abort, the report is printed
+ * then as well. */
+
+#include "admission.h"
+#include "aperiodic.h"
+#include "edf.h"
+#include "sim.h"
+#include "tasks.h"
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define EDFSIM_MAX_TASKS 16
+#define EDFSIM_MAIN_PRIORITY (tskIDLE_PRIORITY + 1)
+
+// the task set of main.c
+extern PeriodicTaskParams task1_params, task2_params, task3_params, ps_params;
+
+typedef struct {
+  PeriodicTaskParams *params;
+  bool accepted;
+  bool pending; // released and not complete yet
+  int64_t released_us;
+  unsigned long jobs;
+  unsigned long misses;
+  int64_t max_response_us;
+} TaskReport;
+
+static PeriodicTaskParams custom_params[EDFSIM_MAX_TASKS];
+static PeriodicTaskParams *task_set[EDFSIM_MAX_TASKS + 1];
+static TaskReport reports[EDFSIM_MAX_TASKS + 1];
+static unsigned int number_of_tasks;
+static WorkloadDistribution distribution = WORKLOAD_UNIFORM;
+static double mean_interarrival_ms = 0;
+static bool schedule_tables = false;
+static SlackComputation slack_computation = SLACK_TABLE;
+static EDFMode mode = EDF_PARTITIONED;
+static SimEvent button_event;
+
+static TaskReport *find_report(void *params) {
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    if (reports[i].params == params)
+      return &reports[i];
+  }
+  // the EDF schedulers wait for notifications as well
+  return NULL;
+}
+
+static void job_released(TaskHandle_t task, void *params) {
+  TaskReport *report = find_report(params);
+  if (report == NULL)
+    return;
+  report->pending = true;
+  report->released_us = sim_now_us();
+}
+
+/* Linked with --wrap, see CMakeLists.txt: the scheduler ends the job here.
+ * The task may only reach its next ulTaskNotifyTake much later, as it
+ * drops to the idle priority meanwhile. */
+bool __real_admission_job_complete(PeriodicTaskParams *params);
+bool __wrap_admission_job_complete(PeriodicTaskParams *params) {
+  TaskReport *report = find_report(params);
+  if (report != NULL && report->pending) {
+    int64_t response_us = sim_now_us() - report->released_us;
+    report->pending = false;
+    report->jobs++;
+    // a bandwidth server has no deadline of its own
+    if (!IS_BANDWIDTH_SERVER(params->type) &&
+        response_us > (int64_t)params->deadline * 1000)
+      report->misses++;
+    if (response_us > report->max_response_us)
+      report->max_response_us = response_us;
+  }
+  return __real_admission_job_complete(params);
+}
+
+static int64_t next_interarrival_us(void) {
+  return (int64_t)(-log(1 - drand48()) * mean_interarrival_ms * 1000);
+}
+
+static void button_fire(void *arg) {
+  sim_gpio_interrupt(GPIO_INPUT_BTN);
+  sim_schedule(&button_event, sim_now_us() + next_interarrival_us());
+}
+
+// returns the number of deadline misses
+static unsigned long print_report(void) {
+  unsigned long jobs = 0, misses = 0;
+
+  printf("\nSimulated %.3f s\n", sim_now_us() / 1e6);
+  printf("%-5s %-8s %8s %8s %8s %9s %10s %10s %8s %12s %12s\n", "Task",
+         "Type", "C [ms]", "T [ms]", "D [ms]", "Partition", "Jobs", "Misses",
+         "Pending", "Max R [ms]", "Busy [ms]");
+  for (unsigned int i = 0; i < number_of_tasks; i++) {
+    TaskReport *report = &reports[i];
+    PeriodicTaskParams *params = report->params;
+    if (!report->accepted) {
+      printf("%-5d %-8s %8lu %8lu %8lu %9s %10s\n", params->id,
+             IS_SERVER(params->type) ? "server" : "task",
+             params->execution_time, params->period, params->deadline, "-",
+             "rejected");
+      continue;
+    }
+    SimTaskStats stats = sim_task_stats(params->handle);
+    printf("%-5d %-8s %8lu %8lu %8lu %9u %10lu %10lu %8s %12.3f %12.3f\n",
+           params->id, IS_SERVER(params->type) ? "server" : "task",
+           params->execution_time, params->period, params->deadline,
+           params->partition, report->jobs, report->misses,
+           report->pending ? "yes" : "no", report->max_response_us / 1e3,
+           stats.executed_us / 1e3);
+    jobs += report->jobs;
+    misses += report->misses;
+  }
+  printf("Jobs: %lu, deadline misses: %lu\n", jobs, misses);
+
+  AperiodicStats aperiodic = aperiodic_stats();
+  if (aperiodic.served > 0 || aperiodic.dropped > 0)
+    printf("Aperiodic jobs: %" PRIu32 " served, %" PRIu32
+           " dropped, mean response %.3f ms, max %.3f ms\n",
+           aperiodic.served, aperiodic.dropped,
+           aperiodic.served > 0
+               ? aperiodic.total_response_time / 1e3 / aperiodic.served
+               : 0.0,
+           aperiodic.max_response_time / 1e3);
+  fflush(stdout);
+  return misses;
+}
+
+// the scheduler aborts on an overrun, see release_jobs of edf.c
+static void overrun_handler(int signal) {
+  print_report();
+  _exit(2);
+}
+
+// app_main of main.c, without the log drain and the analysis printouts
+static void startup_task(void *v_params) {
+  AcceptanceTestResult results[EDFSIM_MAX_TASKS + 1];
+
+  task_setup(WORKLOAD_CPU, distribution);
+  ssd1306_setup();
+  admission_setup(PARTITION_WORST_FIT);
+  edf_setup(MAX_ADMITTED_TASKS, mode, schedule_tables, slack_computation);
+  admission_add_set(task_set, number_of_tasks, results);
+  for (unsigned int i = 0; i < number_of_tasks; i++)
+    reports[i] = (TaskReport){.params = task_set[i],
+                              .accepted = results[i].accepted};
+  if (mean_interarrival_ms > 0)
+    sim_schedule(&button_event, next_interarrival_us());
+  edf_scheduler(admission_task_set());
+}
+
+// "C:T[:D],..." in milliseconds
+static bool parse_tasks(char *list) {
+  number_of_tasks = 0;
+  for (char *item = strtok(list, ","); item != NULL;
+       item = strtok(NULL, ",")) {
+    unsigned long execution_time, period, deadline;
+    int fields = sscanf(item, "%lu:%lu:%lu", &execution_time, &period,
+                        &deadline);
+    if (number_of_tasks == EDFSIM_MAX_TASKS || fields < 2 ||
+        execution_time == 0 || period == 0)
+      return false;
+    custom_params[number_of_tasks] = (PeriodicTaskParams){
+        .id = number_of_tasks + 1,
+        .execution_time = execution_time,
+        .period = period,
+        .deadline = fields == 3 ? deadline : period,
+        .gpio = No_GPIO,
+        .type = PERIODIC_TASK,
+    };
+    task_set[number_of_tasks] = &custom_params[number_of_tasks];
+    number_of_tasks++;
+  }
+  return number_of_tasks > 0;
+}
+
+// server type of the aperiodic jobs, for comparison on the same task set
+static bool parse_server(const char *name) {
+  static const char *const names[] = {"deferrable", "sporadic", "tbs", "cbs",
+                                      "slack"};
+  static const TaskType_t types[] = {PERIODIC_SERVER, SPORADIC_SERVER,
+                                     TOTAL_BANDWIDTH_SERVER,
+                                     CONSTANT_BANDWIDTH_SERVER, SLACK_STEALER};
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    if (strcmp(name, names[i]) == 0) {
+      ps_params.type = types[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -t C:T[:D],...  periodic tasks in ms instead of those of "
+          "main.c, the\n"
+          "                  server of main.c is kept\n"
+          "  -s SECONDS      simulated time (default 3600)\n"
+          "  -d DIST         constant | uniform | triangular execution "
+          "times\n"
+          "                  (default uniform)\n"
+          "  -e PERMILLE     scale of the execution times; jobs draw up to "
+          "80%% of the\n"
+          "                  WCET, so above 1250 they overrun it (default "
+          "1000)\n"
+          "  -a MS           mean time between button presses, 0 for none "
+          "(default 0)\n"
+          "  -S SEED         random seed of the button presses (default 1)\n"
+          "  -T              dispatch from the tables of schedule_table.c, "
+          "see\n"
+          "                  Host/schedgen\n"
+          "  -A SERVER       deferrable | sporadic | tbs | cbs | slack server "
+          "of the\n"
+          "                  aperiodic jobs instead of the one of main.c\n"
+          "  -L SLACK        online | table slack computation of the slack "
+          "server\n"
+          "                  (default table)\n"
+          "  -m MODE         partitioned | global EDF on the %d cores "
+          "(default\n"
+          "                  partitioned)\n",
+          program, portNUM_PROCESSORS);
+}
+
+int main(int argc, char **argv) {
+  double seconds = 3600;
+  unsigned int scale = 1000;
+  long seed = 1;
+  int opt;
+
+  task_set[0] = &task1_params;
+  task_set[1] = &task2_params;
+  task_set[2] = &task3_params;
+  number_of_tasks = 3;
+  while ((opt = getopt(argc, argv, "t:s:d:e:a:S:TA:L:m:h")) != -1) {
+    switch (opt) {
+    case 't':
+      if (!parse_tasks(optarg)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 's':
+      seconds = strtod(optarg, NULL);
+      break;
+    case 'd':
+      if (strcmp(optarg, "constant") == 0) {
+        distribution = WORKLOAD_CONSTANT;
+      } else if (strcmp(optarg, "uniform") == 0) {
+        distribution = WORKLOAD_UNIFORM;
+      } else if (strcmp(optarg, "triangular") == 0) {
+        distribution = WORKLOAD_TRIANGULAR;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'e':
+      scale = strtoul(optarg, NULL, 10);
+      break;
+    case 'a':
+      mean_interarrival_ms = strtod(optarg, NULL);
+      break;
+    case 'S':
+      seed = strtol(optarg, NULL, 10);
+      break;
+    case 'T':
+      schedule_tables = true;
+      break;
+    case 'A':
+      if (!parse_server(optarg)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'L':
+      if (strcmp(optarg, "online") == 0) {
+        slack_computation = SLACK_ONLINE;
+      } else if (strcmp(optarg, "table") == 0) {
+        slack_computation = SLACK_TABLE;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'm':
+      if (strcmp(optarg, "partitioned") == 0) {
+        mode = EDF_PARTITIONED;
+      } else if (strcmp(optarg, "global") == 0) {
+        mode = EDF_GLOBAL;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (seconds <= 0 || scale == 0 || mean_interarrival_ms < 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  task_set[number_of_tasks++] = &ps_params;
+
+  srand48(seed);
+  sim_set_cores(portNUM_PROCESSORS);
+  sim_set_workload_scale(scale);
+  sim_set_hooks(&(SimHooks){.notified = job_released});
+  button_event = (SimEvent){.fire = button_fire};
+  signal(SIGABRT, overrun_handler);
+  // app_main runs on core 0, see CONFIG_ESP_MAIN_TASK_AFFINITY
+  xTaskCreatePinnedToCore(startup_task, "main", configMINIMAL_STACK_SIZE, NULL,
+                          EDFSIM_MAIN_PRIORITY, NULL, 0);
+  sim_run((int64_t)(seconds * 1e6));
+  // a deadline miss fails the run, e.g., a slack stealer that took too much
+  return print_report() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+/* Timers, clocks and GPIOs of the simulation. Both clocks count the
+ * virtual time of sim.h, timer callbacks fire as sim events. */
+
+#define SIM_GPIOS 40
+
+struct esp_timer {
+  SimEvent event;
+  esp_timer_create_args_t args;
+};
+
+static gpio_isr_t isr_handlers[SIM_GPIOS];
+static void *isr_args[SIM_GPIOS];
+
+uint32_t esp_cpu_get_cycle_count(void) {
+  return (uint32_t)(sim_now_us() * SIM_CPU_MHZ);
+}
+
+int64_t esp_timer_get_time(void) { return sim_now_us(); }
+
+static void timer_fire(void *arg) {
+  struct esp_timer *timer = arg;
+  timer->args.callback(timer->args.arg);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *handle) {
+  struct esp_timer *timer = calloc(1, sizeof(struct esp_timer));
+  if (timer == NULL)
+    return ESP_FAIL;
+  timer->args = *args;
+  timer->event = (SimEvent){.fire = timer_fire, .arg = timer};
+  *handle = timer;
+  return ESP_OK;
+}
+
+// like ESP-IDF, a timer that is still armed cannot be started again
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  if (timer->event.queued)
+    return ESP_FAIL;
+  sim_schedule(&timer->event, sim_now_us() + (int64_t)timeout_us);
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->event.queued)
+    return ESP_FAIL;
+  sim_cancel(&timer->event);
+  return ESP_OK;
+}
+
+// The LEDs are not simulated, only the button interrupts
+esp_err_t gpio_config(const gpio_config_t *config) { return ESP_OK; }
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) { return ESP_OK; }
+esp_err_t gpio_install_isr_service(int flags) { return ESP_OK; }
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, gpio_isr_t handler,
+                               void *args) {
+  if (gpio < 0 || gpio >= SIM_GPIOS)
+    return ESP_FAIL;
+  isr_handlers[gpio] = handler;
+  isr_args[gpio] = args;
+  return ESP_OK;
+}
+
+void sim_gpio_interrupt(gpio_num_t gpio) {
+  if (gpio >= 0 && gpio < SIM_GPIOS && isr_handlers[gpio] != NULL)
+    isr_handlers[gpio](isr_args[gpio]);
+}
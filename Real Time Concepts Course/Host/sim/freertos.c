@@ -0,0 +1,626 @@
+#include "freertos/semphr.h"
+#include "sim.h"
+#include <stdio.h>
+#include <ucontext.h>
+
+/* FreeRTOS API of the simulation, see sim.h. Tasks switch only where the
+ * real kernel could switch as well: in blocking calls, after waking a
+ * higher priority task, and while executing a workload. */
+
+typedef struct {
+  UBaseType_t count;
+  UBaseType_t max_count;
+  bool mutex;
+  struct SimTask *holder; // of a mutex that is taken
+} SimSemaphore;
+
+typedef struct SimTask {
+  ucontext_t context;
+  void *stack;
+  TaskFunction_t function;
+  void *params;
+  char name[configMAX_TASK_NAME_LEN];
+  UBaseType_t priority;      // raised above base_priority while inherited
+  UBaseType_t base_priority; // set with vTaskPrioritySet
+  unsigned int mutexes_held;
+  BaseType_t affinity;  // core it is pinned to, or tskNO_AFFINITY
+  unsigned int core;    // core it runs on, or ran on last
+  eTaskState state;     // eRunning while it has a core
+  uint64_t order;       // first come, first served among equal priorities
+  int64_t executing_us; // left of its sim_execute, 0 while in host code
+  uint32_t notifications;
+  bool waiting_for_notification;
+  SimSemaphore *waiting_on;
+  bool timed_out;
+  int64_t blocked_since_us;
+  SimEvent timeout;
+  SimTaskStats stats;
+  struct SimTask *next;
+} SimTask;
+
+// all tasks, deleted ones are kept for their statistics
+static SimTask *tasks = NULL;
+static SimTask *running[SIM_MAX_CORES]; // may have blocked since
+static SimTask *current = NULL;         // the one running host code
+static unsigned int cores = 1;
+static ucontext_t scheduler_context;
+static SimEvent *events = NULL; // sorted by time
+static int64_t now_us = 0, stop_us = 0;
+static uint64_t order = 0;
+static bool in_interrupt = false;
+static unsigned int scheduler_suspended = 0;
+static unsigned int suspended_core; // of the task that suspended it
+static SimHooks hooks;
+
+static void fatal(const char *function, const char *reason) {
+  fprintf(stderr, "ERROR: %s %s at %lld us\n", function, reason,
+          (long long)now_us);
+  abort();
+}
+
+int64_t sim_now_us(void) { return now_us; }
+
+void sim_set_cores(unsigned int count) {
+  if (count == 0 || count > SIM_MAX_CORES || tasks != NULL)
+    fatal(__func__, "needs 1 to SIM_MAX_CORES cores before the first task");
+  cores = count;
+}
+
+static int64_t tick_time_us(TickType_t tick) {
+  return (int64_t)tick * SIM_TICK_US;
+}
+
+void sim_cancel(SimEvent *event) {
+  if (!event->queued)
+    return;
+  for (SimEvent **link = &events; *link != NULL; link = &(*link)->next) {
+    if (*link == event) {
+      *link = event->next;
+      break;
+    }
+  }
+  event->queued = false;
+}
+
+void sim_schedule(SimEvent *event, int64_t time_us) {
+  sim_cancel(event);
+  event->time_us = time_us < now_us ? now_us : time_us;
+  // after the events of the same time, so they fire in order of scheduling
+  SimEvent **link = &events;
+  while (*link != NULL && (*link)->time_us <= event->time_us)
+    link = &(*link)->next;
+  event->next = *link;
+  *link = event;
+  event->queued = true;
+}
+
+static void fire_due_events(void) {
+  bool interrupted = in_interrupt;
+  in_interrupt = true;
+  while (events != NULL && events->time_us <= now_us) {
+    SimEvent *event = events;
+    events = event->next;
+    event->queued = false;
+    event->fire(event->arg);
+  }
+  in_interrupt = interrupted;
+}
+
+/* Like FreeRTOS, a running task is not preempted by an equal priority and
+ * a preempted one keeps its place among its priority. */
+static bool runs_before(SimTask *a, SimTask *b) {
+  if (b == NULL || a->priority != b->priority)
+    return b == NULL || a->priority > b->priority;
+  if ((a->state == eRunning) != (b->state == eRunning))
+    return a->state == eRunning;
+  return a->order < b->order;
+}
+
+static bool may_run_on(SimTask *task, unsigned int core) {
+  return task->affinity == tskNO_AFFINITY ||
+         task->affinity == (BaseType_t)core;
+}
+
+// the task that runs on 'core', NULL if it is idle
+static SimTask *occupant(unsigned int core) {
+  SimTask *task = running[core];
+  return task != NULL && task->state == eRunning ? task : NULL;
+}
+
+static bool is_assigned(SimTask *task, SimTask *assigned[]) {
+  for (unsigned int core = 0; core < cores; core++) {
+    if (assigned[core] == task)
+      return true;
+  }
+  return false;
+}
+
+// 'a' runs a lower priority than 'b' or nothing at all
+static bool is_less_busy(unsigned int a, unsigned int b) {
+  SimTask *task_a = occupant(a), *task_b = occupant(b);
+  return task_b != NULL && (task_a == NULL || runs_before(task_b, task_a));
+}
+
+/* Core of the assignment that 'task' would take, 'cores' if none: its own
+ * core if it runs, otherwise an idle core before the one running the lowest
+ * priority. */
+static unsigned int free_core(SimTask *task, SimTask *assigned[]) {
+  if (task->affinity != tskNO_AFFINITY)
+    return assigned[task->affinity] == NULL ? (unsigned int)task->affinity
+                                            : cores;
+  if (task->state == eRunning && assigned[task->core] == NULL)
+    return task->core;
+  unsigned int best = cores;
+  for (unsigned int core = 0; core < cores; core++) {
+    if (assigned[core] == NULL && (best == cores || is_less_busy(core, best)))
+      best = core;
+  }
+  return best;
+}
+
+/* The task each core runs next: the ready tasks in the order of runs_before,
+ * each on a core it may run on. The core that suspended the scheduler keeps
+ * its task. */
+static void assign(SimTask *assigned[]) {
+  for (unsigned int core = 0; core < cores; core++)
+    assigned[core] = NULL;
+  if (scheduler_suspended > 0)
+    assigned[suspended_core] = occupant(suspended_core);
+  while (true) {
+    SimTask *best = NULL;
+    unsigned int best_core = cores;
+    for (SimTask *task = tasks; task != NULL; task = task->next) {
+      if ((task->state != eReady && task->state != eRunning) ||
+          !runs_before(task, best) || is_assigned(task, assigned))
+        continue;
+      unsigned int core = free_core(task, assigned);
+      if (core < cores) {
+        best = task;
+        best_core = core;
+      }
+    }
+    if (best == NULL)
+      return;
+    assigned[best_core] = best;
+  }
+}
+
+static void dispatch(void) {
+  SimTask *assigned[SIM_MAX_CORES];
+  assign(assigned);
+  for (unsigned int core = 0; core < cores; core++) {
+    SimTask *task = occupant(core);
+    if (task != NULL && !is_assigned(task, assigned)) {
+      task->state = eReady;
+      task->stats.preemptions++;
+    }
+  }
+  for (unsigned int core = 0; core < cores; core++) {
+    running[core] = assigned[core];
+    if (assigned[core] != NULL) {
+      assigned[core]->state = eRunning;
+      assigned[core]->core = core;
+    }
+  }
+}
+
+// another ready task of the same priority, which gets the next time slice
+static bool shares_priority(SimTask *task) {
+  for (SimTask *other = tasks; other != NULL; other = other->next) {
+    if (other->state == eReady && other->priority == task->priority &&
+        may_run_on(other, task->core))
+      return true;
+  }
+  return false;
+}
+
+static void make_ready(SimTask *task) {
+  task->state = eReady;
+  task->order = ++order;
+}
+
+static void switch_to_scheduler(void) {
+  swapcontext(&current->context, &scheduler_context);
+}
+
+// preempt the running task if another task takes its core
+static bool yield_if_preempted(void) {
+  if (current == NULL || in_interrupt || scheduler_suspended > 0)
+    return false;
+  SimTask *assigned[SIM_MAX_CORES];
+  assign(assigned);
+  if (assigned[current->core] == current)
+    return false;
+  switch_to_scheduler();
+  return true;
+}
+
+static void wake(SimTask *task) {
+  sim_cancel(&task->timeout);
+  if (task->waiting_on != NULL) {
+    int64_t blocked_us = now_us - task->blocked_since_us;
+    task->stats.blocked_on_semaphores_us += blocked_us;
+    task->stats.semaphore_blocks++;
+    if (hooks.semaphore_blocked != NULL)
+      hooks.semaphore_blocked(task, task->waiting_on, blocked_us);
+    task->waiting_on = NULL;
+  }
+  task->waiting_for_notification = false;
+  make_ready(task);
+}
+
+static void timeout_fire(void *arg) {
+  SimTask *task = arg;
+  task->timed_out = true;
+  wake(task);
+}
+
+/* Block the running task until it is woken or until 'wake_us'. Returns
+ * false on the timeout. */
+static bool block(const char *function, int64_t wake_us) {
+  if (current == NULL || in_interrupt)
+    fatal(function, "blocks outside of a task");
+  if (scheduler_suspended > 0)
+    fatal(function, "blocks while the scheduler is suspended");
+  current->state = eBlocked;
+  current->timed_out = false;
+  current->blocked_since_us = now_us;
+  if (wake_us != INT64_MAX)
+    sim_schedule(&current->timeout, wake_us);
+  switch_to_scheduler();
+  return !current->timed_out;
+}
+
+static int64_t timeout_us(TickType_t ticks) {
+  return ticks == portMAX_DELAY ? INT64_MAX
+                                : tick_time_us(xTaskGetTickCount() + ticks);
+}
+
+// a task on a core that is not executing, so its host code continues
+static SimTask *next_in_host_code(void) {
+  for (unsigned int core = 0; core < cores; core++) {
+    SimTask *task = occupant(core);
+    if (task != NULL && task->executing_us == 0)
+      return task;
+  }
+  return NULL;
+}
+
+/* Execute on all cores until the first execution ends, an event is due or
+ * a time slice ends. A slice only ends before the next event, after which
+ * the running task may have been preempted instead. */
+static void execute_cores(void) {
+  int64_t event_us = events != NULL ? events->time_us : INT64_MAX;
+  int64_t until_us = event_us < stop_us ? event_us : stop_us;
+  int64_t slice_end_us = tick_time_us(xTaskGetTickCount() + 1);
+  bool sliced[SIM_MAX_CORES];
+  for (unsigned int core = 0; core < cores; core++) {
+    SimTask *task = occupant(core);
+    sliced[core] = task != NULL && shares_priority(task) &&
+                   slice_end_us < until_us;
+  }
+  for (unsigned int core = 0; core < cores; core++) {
+    SimTask *task = occupant(core);
+    if (task != NULL && now_us + task->executing_us < until_us)
+      until_us = now_us + task->executing_us;
+    if (sliced[core] && slice_end_us < until_us)
+      until_us = slice_end_us;
+  }
+
+  int64_t step_us = until_us > now_us ? until_us - now_us : 0;
+  now_us += step_us;
+  for (unsigned int core = 0; core < cores; core++) {
+    SimTask *task = occupant(core);
+    if (task == NULL)
+      continue;
+    task->executing_us -= step_us;
+    task->stats.executed_us += step_us;
+    // the time slice is over, the task goes behind its equals
+    if (sliced[core] && now_us == slice_end_us && scheduler_suspended == 0)
+      make_ready(task);
+  }
+}
+
+void sim_run(int64_t until_us) {
+  stop_us = until_us;
+  while (true) {
+    fire_due_events();
+    dispatch();
+    if (now_us >= stop_us)
+      return;
+    current = next_in_host_code();
+    if (current == NULL) {
+      // idle or executing until the next event
+      execute_cores();
+      continue;
+    }
+    swapcontext(&scheduler_context, &current->context);
+    if (current->state == eDeleted) {
+      free(current->stack);
+      current->stack = NULL;
+    }
+    current = NULL;
+  }
+}
+
+/* The task stays on its core while the others run their host code, and
+ * continues once execute_cores used up 'duration_us'. */
+void sim_execute(int64_t duration_us) {
+  if (current == NULL || in_interrupt)
+    fatal(__func__, "executes outside of a task");
+  if (duration_us <= 0)
+    return;
+  current->executing_us = duration_us;
+  switch_to_scheduler();
+}
+
+void sim_set_hooks(const SimHooks *observers) { hooks = *observers; }
+
+SimTaskStats sim_task_stats(TaskHandle_t handle) {
+  return ((SimTask *)handle)->stats;
+}
+
+const char *sim_task_name(TaskHandle_t handle) {
+  return ((SimTask *)handle)->name;
+}
+
+void *pvPortMalloc(size_t size) { return malloc(size); }
+void vPortFree(void *ptr) { free(ptr); }
+
+static void task_entry(void) {
+  current->function(current->params);
+  fatal(current->name, "returned from its task function");
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name,
+                                   uint32_t stack_depth, void *params,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  if (core != tskNO_AFFINITY && (core < 0 || core >= (BaseType_t)cores))
+    return pdFAIL;
+  SimTask *task = calloc(1, sizeof(SimTask));
+  void *stack = malloc(SIM_STACK_SIZE);
+  if (task == NULL || stack == NULL || getcontext(&task->context) != 0) {
+    free(task);
+    free(stack);
+    return pdFAIL;
+  }
+  task->context.uc_stack.ss_sp = stack;
+  task->context.uc_stack.ss_size = SIM_STACK_SIZE;
+  task->context.uc_link = NULL;
+  makecontext(&task->context, task_entry, 0);
+  task->stack = stack;
+  task->function = function;
+  task->params = params;
+  snprintf(task->name, sizeof(task->name), "%s", name);
+  task->priority = priority;
+  task->base_priority = priority;
+  task->affinity = core;
+  task->core = core != tskNO_AFFINITY ? (unsigned int)core : 0;
+  task->timeout = (SimEvent){.fire = timeout_fire, .arg = task};
+  task->next = tasks;
+  tasks = task;
+  make_ready(task);
+  if (handle != NULL)
+    *handle = task;
+  yield_if_preempted();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name,
+                       uint32_t stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(function, name, stack_depth, params, priority,
+                                 handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t handle) {
+  SimTask *task = handle != NULL ? handle : current;
+  sim_cancel(&task->timeout);
+  task->waiting_on = NULL;
+  task->state = eDeleted;
+  task->stats.deleted_us = now_us;
+  if (task == current) {
+    switch_to_scheduler();
+    fatal(__func__, "resumed a deleted task");
+  }
+  free(task->stack);
+  task->stack = NULL;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks > 0) {
+    block(__func__, tick_time_us(xTaskGetTickCount() + ticks));
+  } else if (shares_priority(current)) {
+    make_ready(current);
+    switch_to_scheduler();
+  }
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake_time, TickType_t increment) {
+  *previous_wake_time += increment;
+  if (*previous_wake_time > xTaskGetTickCount())
+    block(__func__, tick_time_us(*previous_wake_time));
+}
+
+TickType_t xTaskGetTickCount(void) { return now_us / SIM_TICK_US; }
+
+static void change_priority(SimTask *task, UBaseType_t priority) {
+  task->priority = priority;
+  // like FreeRTOS, the task goes to the end of its new priority
+  if (task->state == eReady)
+    task->order = ++order;
+}
+
+void vTaskPrioritySet(TaskHandle_t handle, UBaseType_t priority) {
+  SimTask *task = handle != NULL ? handle : current;
+  // a higher inherited priority lasts until the task gives its mutexes
+  bool inherited = task->priority != task->base_priority;
+  task->base_priority = priority;
+  if (task->priority == priority || (inherited && priority < task->priority))
+    return;
+  change_priority(task, priority);
+  yield_if_preempted();
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t handle) {
+  return ((SimTask *)(handle != NULL ? handle : current))->priority;
+}
+
+eTaskState eTaskGetState(TaskHandle_t handle) {
+  return ((SimTask *)handle)->state;
+}
+
+void vTaskSuspend(TaskHandle_t handle) {
+  SimTask *task = handle != NULL ? handle : current;
+  sim_cancel(&task->timeout);
+  task->waiting_on = NULL;
+  task->waiting_for_notification = false;
+  task->state = eSuspended;
+  if (task == current)
+    switch_to_scheduler();
+}
+
+void vTaskResume(TaskHandle_t handle) {
+  SimTask *task = handle;
+  if (task->state != eSuspended)
+    return;
+  make_ready(task);
+  yield_if_preempted();
+}
+
+// only the core of the calling task stops switching, like on ESP-IDF
+void vTaskSuspendAll(void) {
+  if (scheduler_suspended++ == 0 && current != NULL)
+    suspended_core = current->core;
+}
+
+BaseType_t xTaskResumeAll(void) {
+  scheduler_suspended--;
+  return yield_if_preempted() ? pdTRUE : pdFALSE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return current; }
+
+// interrupts are taken on core 0
+BaseType_t xPortGetCoreID(void) {
+  return current != NULL && !in_interrupt ? (BaseType_t)current->core : 0;
+}
+
+static void notify(SimTask *task) {
+  task->notifications++;
+  if (hooks.notified != NULL)
+    hooks.notified(task, task->params);
+  if (task->state == eBlocked && task->waiting_for_notification)
+    wake(task);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+  notify(handle);
+  yield_if_preempted();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t handle,
+                            BaseType_t *higher_prio_woken) {
+  SimTask *task = handle;
+  notify(task);
+  if (higher_prio_woken != NULL && task->state == eReady &&
+      (current == NULL || task->priority > current->priority))
+    *higher_prio_woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+  if (current->notifications == 0 && ticks_to_wait > 0) {
+    current->waiting_for_notification = true;
+    block(__func__, timeout_us(ticks_to_wait));
+  }
+  uint32_t value = current->notifications;
+  if (value > 0)
+    current->notifications = clear_on_exit ? 0 : value - 1;
+  return value;
+}
+
+static SemaphoreHandle_t create_semaphore(UBaseType_t count) {
+  SimSemaphore *semaphore = calloc(1, sizeof(SimSemaphore));
+  if (semaphore != NULL)
+    *semaphore = (SimSemaphore){.count = count, .max_count = 1};
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return create_semaphore(0); }
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  SimSemaphore *semaphore = create_semaphore(1);
+  if (semaphore != NULL)
+    semaphore->mutex = true;
+  return semaphore;
+}
+
+static void hold(SimSemaphore *semaphore, SimTask *task) {
+  if (!semaphore->mutex)
+    return;
+  semaphore->holder = task;
+  task->mutexes_held++;
+}
+
+/* Like FreeRTOS, the holder of a mutex runs at the priority of its waiters
+ * until it gave all of its mutexes. It keeps that priority should a waiter
+ * time out. */
+static void inherit(SimSemaphore *semaphore) {
+  SimTask *holder = semaphore->holder;
+  if (semaphore->mutex && holder != NULL &&
+      holder->priority < current->priority)
+    change_priority(holder, current->priority);
+}
+
+static void disinherit(SimSemaphore *semaphore) {
+  SimTask *holder = semaphore->holder;
+  if (!semaphore->mutex || holder == NULL)
+    return;
+  semaphore->holder = NULL;
+  if (--holder->mutexes_held == 0 && holder->priority != holder->base_priority)
+    change_priority(holder, holder->base_priority);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t ticks) {
+  SimSemaphore *semaphore = handle;
+  if (semaphore->count > 0) {
+    semaphore->count--;
+    hold(semaphore, current);
+    return pdTRUE;
+  }
+  if (ticks == 0)
+    return pdFALSE;
+  // a give hands the semaphore over to the waiter without counting it
+  inherit(semaphore);
+  current->waiting_on = semaphore;
+  return block(__func__, timeout_us(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle) {
+  SimSemaphore *semaphore = handle;
+  SimTask *waiter = NULL;
+  for (SimTask *task = tasks; task != NULL; task = task->next) {
+    if (task->state == eBlocked && task->waiting_on == semaphore &&
+        (waiter == NULL || task->priority > waiter->priority ||
+         (task->priority == waiter->priority &&
+          task->blocked_since_us < waiter->blocked_since_us)))
+      waiter = task;
+  }
+  if (semaphore->count >= semaphore->max_count && waiter == NULL)
+    return pdFALSE;
+  disinherit(semaphore);
+  if (waiter != NULL) {
+    wake(waiter);
+    hold(semaphore, waiter);
+  } else {
+    semaphore->count++;
+  }
+  yield_if_preempted();
+  return pdTRUE;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t handle) {
+  return ((SimSemaphore *)handle)->count;
+}
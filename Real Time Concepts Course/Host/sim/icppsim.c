@@ -0,0 +1,128 @@
+/* icppsim: the ICPP schedule of Assignment 4 in the discrete-event
+ * simulation of sim.h.
+ *
+ * Runs app_main of Assignment 4 unchanged and presses the button at a fixed
+ * interval, so every press starts the next time unit of the schedule. For
+ * every task, the report lists when it completed and how long it waited on
+ * the resource and ceiling semaphores of critical_section.c, i.e., the
+ * blocking the protocol caused. Waiting for the next time unit is not
+ * counted. The log of the tasks is printed by the drain task of binlog once
+ * all tasks completed and the core is idle. */
+
+#include "sim.h"
+#include "tasks.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ICPPSIM_MAIN_PRIORITY (tskIDLE_PRIORITY + 1)
+
+// the task set of main.c and the semaphores of the schedule in tasks.c
+extern PeriodicTaskParams task1_params, task2_params, task3_params;
+extern SemaphoreHandle_t button_semaphore, tick_semaphore, blinking_semaphore;
+extern DisplayedState state;
+void app_main(void);
+
+typedef struct {
+  PeriodicTaskParams *params;
+  int64_t blocked_us;
+  unsigned long blocks;
+  int completed_tick; // -1 while running
+} TaskReport;
+
+static TaskReport reports[] = {{&task1_params}, {&task2_params},
+                               {&task3_params}};
+#define NUMBER_OF_REPORTS (sizeof(reports) / sizeof(reports[0]))
+
+static SimEvent button_event;
+
+static void semaphore_blocked(TaskHandle_t task, SemaphoreHandle_t semaphore,
+                              int64_t blocked_us) {
+  if (semaphore == button_semaphore || semaphore == tick_semaphore ||
+      semaphore == blinking_semaphore)
+    return;
+  for (unsigned int i = 0; i < NUMBER_OF_REPORTS; i++) {
+    if (reports[i].params->handle == task) {
+      reports[i].blocked_us += blocked_us;
+      reports[i].blocks++;
+    }
+  }
+}
+
+static void button_fire(void *arg) { sim_gpio_interrupt(GPIO_INPUT_BTN); }
+
+static void main_task(void *v_params) {
+  app_main();
+  vTaskDelete(NULL);
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -b MS       time between button presses, above the debounce "
+          "time of\n"
+          "              1000 ms (default 1500)\n"
+          "  -n PRESSES  button presses, i.e., time units to simulate "
+          "(default 20)\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  unsigned long interval_ms = 1500, presses = 20;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:n:h")) != -1) {
+    switch (opt) {
+    case 'b':
+      interval_ms = strtoul(optarg, NULL, 10);
+      break;
+    case 'n':
+      presses = strtoul(optarg, NULL, 10);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (interval_ms <= 1000 || presses == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int i = 0; i < NUMBER_OF_REPORTS; i++)
+    reports[i].completed_tick = -1;
+  sim_set_hooks(&(SimHooks){.semaphore_blocked = semaphore_blocked});
+  button_event = (SimEvent){.fire = button_fire};
+  xTaskCreate(main_task, "main", configMINIMAL_STACK_SIZE, NULL,
+              ICPPSIM_MAIN_PRIORITY, NULL);
+  // a press starts the next unit, it ends with the press after it
+  for (unsigned long press = 1; press <= presses + 1; press++) {
+    int64_t press_us = (int64_t)press * interval_ms * 1000;
+    sim_run(press_us);
+    for (unsigned int i = 0; i < NUMBER_OF_REPORTS; i++) {
+      TaskHandle_t handle = reports[i].params->handle;
+      if (reports[i].completed_tick < 0 && handle != NULL &&
+          eTaskGetState(handle) == eDeleted)
+        reports[i].completed_tick = state.tick;
+    }
+    if (press <= presses)
+      sim_schedule(&button_event, press_us);
+  }
+
+  printf("\n%-5s %8s %8s %8s %10s %8s %14s %14s\n", "Task", "Priority",
+         "Release", "C", "Completed", "Blocks", "Blocked [ms]",
+         "Blocked [unit]");
+  for (unsigned int i = 0; i < NUMBER_OF_REPORTS; i++) {
+    TaskReport *report = &reports[i];
+    PeriodicTaskParams *params = report->params;
+    char completed[16] = "-";
+    if (report->completed_tick >= 0)
+      snprintf(completed, sizeof(completed), "%d", report->completed_tick);
+    printf("%-5s %8lu %8lu %8lu %10s %8lu %14.3f %14.3f\n", params->id,
+           uxTaskPriorityGet(params->handle), params->release_time,
+           params->execution_time, completed, report->blocks,
+           report->blocked_us / 1e3,
+           report->blocked_us / 1e3 / interval_ms);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Discrete-event simulation of FreeRTOS on one or more cores.
+ *
+ * Every task is a coroutine with a stack of its own, and only one of them
+ * runs host code at a time. Host code takes no virtual time: only the
+ * workload kernels (workload_run) execute for a duration, see sim_execute.
+ * The clock jumps from event to event: a timer, the timeout of a blocked
+ * task, the end of an execution, a tick that ends a time slice, or an event
+ * of the simulation such as a button press. Every core runs the highest
+ * priority ready task that may run there, i.e., is pinned to it or to no
+ * core, and equal priorities share a core in time slices of one tick, like
+ * FreeRTOS with configUSE_PREEMPTION and configUSE_TIME_SLICING. A running
+ * task keeps its core, others take an idle core first, so tasks without
+ * affinity migrate only when preempted.
+ *
+ * Timer callbacks and sim events run in interrupt context on core 0: they
+ * may wake tasks but never block, and a task they wake only runs after
+ * them. The cores share no caches or buses. Mutexes inherit priorities. */
+
+// clock of the simulated CPU, esp_cpu_get_cycle_count counts at this rate
+#define SIM_CPU_MHZ 240
+#define SIM_TICK_US (1000000 / configTICK_RATE_HZ)
+#define SIM_STACK_SIZE (256 * 1024)
+#define SIM_MAX_CORES 8
+
+typedef struct SimEvent {
+  int64_t time_us;
+  void (*fire)(void *arg);
+  void *arg;
+  bool queued;
+  struct SimEvent *next;
+} SimEvent;
+
+// time a task spent in each way, in microseconds
+typedef struct {
+  int64_t executed_us;
+  int64_t blocked_on_semaphores_us; // waiting in xSemaphoreTake
+  unsigned long semaphore_blocks;   // xSemaphoreTake calls that waited
+  unsigned long preemptions;
+  int64_t deleted_us; // time of vTaskDelete, 0 while the task exists
+} SimTaskStats;
+
+/* Observers of the kernel, all optional. 'notified' sees every task
+ * notification, e.g., the release of a job. 'semaphore_blocked' sees every
+ * xSemaphoreTake that waited, once it returns. */
+typedef struct {
+  void (*notified)(TaskHandle_t task, void *params);
+  void (*semaphore_blocked)(TaskHandle_t task, SemaphoreHandle_t semaphore,
+                            int64_t blocked_us);
+} SimHooks;
+
+int64_t sim_now_us(void);
+
+/* Simulate 'count' cores, at most SIM_MAX_CORES and 1 by default. Only
+ * before the first task is created; the code under simulation should be
+ * built with portNUM_PROCESSORS of the same value. */
+void sim_set_cores(unsigned int count);
+
+/* Run the ready tasks and fire the events until 'until_us'. Tasks that are
+ * still running then continue with the next call. */
+void sim_run(int64_t until_us);
+
+/* Execute on the core of the calling task for 'duration_us'. Events that
+ * fall into this time fire on time, the other cores run meanwhile, and the
+ * task may be preempted or migrate. */
+void sim_execute(int64_t duration_us);
+
+// fire 'event' at 'time_us'; it may schedule itself again
+void sim_schedule(SimEvent *event, int64_t time_us);
+void sim_cancel(SimEvent *event);
+
+/* Call the handler registered with gpio_isr_handler_add for 'gpio', as if
+ * its pin saw an edge. Only from a sim event. */
+void sim_gpio_interrupt(gpio_num_t gpio);
+
+void sim_set_hooks(const SimHooks *hooks);
+SimTaskStats sim_task_stats(TaskHandle_t task);
+const char *sim_task_name(TaskHandle_t task);
+
+/* Scale of the workload kernels in permille: above 1000, every job runs
+ * longer than it was drawn, e.g., to provoke overruns. */
+void sim_set_workload_scale(unsigned int permille);
+
+#endif
@@ -0,0 +1,25 @@
+#include "sim.h"
+#include "workload.h"
+
+/* Kernels of workload.h in the simulation: they execute for virtual time
+ * instead of iterations, on a CPU of SIM_CPU_MHZ. Which kernel runs does
+ * not matter, there are no caches or other cores to contend for. */
+
+static unsigned int scale_permille = 1000;
+
+void sim_set_workload_scale(unsigned int permille) {
+  scale_permille = permille;
+}
+
+// nothing to measure, the simulated CPU runs at a fixed clock
+void workload_calibrate() {}
+
+uint64_t workload_ms_to_cycles(uint32_t ms) {
+  return (uint64_t)ms * 1000 * SIM_CPU_MHZ;
+}
+
+void workload_run(WorkloadKernel kernel, uint64_t cycles) {
+  if (kernel >= WORKLOAD_KERNELS)
+    return;
+  sim_execute(cycles * scale_permille / 1000 / SIM_CPU_MHZ);
+}
@@ -0,0 +1,161 @@
+#include "binlog.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <stdio.h>
+
+#define BINLOG_SEEN_LENGTH 128 // a power of two
+
+typedef struct {
+  const char *format;
+  uint32_t timestamp; // microseconds, wraps after 71 minutes
+  uint32_t count;
+  BinlogWord args[BINLOG_MAX_ARGS];
+} BinlogRecord;
+
+/* Single producer ring per core: writers of one core are serialized by
+ * masking interrupts for the copy, the drain task is the only consumer. */
+typedef struct {
+  BinlogRecord records[BINLOG_RING_LENGTH];
+  uint32_t head; // next record to write
+  uint32_t tail; // next record to drain
+  uint32_t dropped;
+} BinlogRing;
+
+static BinlogRing rings[portNUM_PROCESSORS];
+static TaskHandle_t drain_task = NULL;
+
+// addresses whose text the host decoder already received
+static const char *seen[BINLOG_SEEN_LENGTH];
+
+void binlog_write(const char *format, unsigned int count,
+                  const BinlogWord *args) {
+  UBaseType_t interrupts = portSET_INTERRUPT_MASK_FROM_ISR();
+  BinlogRing *ring = &rings[xPortGetCoreID()];
+  uint32_t head = ring->head;
+
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) ==
+      BINLOG_RING_LENGTH) {
+    ring->dropped++;
+  } else {
+    BinlogRecord *record = &ring->records[head % BINLOG_RING_LENGTH];
+    if (count > BINLOG_MAX_ARGS)
+      count = BINLOG_MAX_ARGS;
+    record->format = format;
+    record->timestamp = (uint32_t)esp_timer_get_time();
+    record->count = count;
+    for (unsigned int i = 0; i < count; i++)
+      record->args[i] = args[i];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+  }
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(interrupts);
+}
+
+static const char *string_argument(BinlogWord address, void *context) {
+  return (const char *)address;
+}
+
+// Returns false if 'text' was sent before; a full table just sends it again
+static bool mark_seen(const char *text) {
+  unsigned int index = ((uintptr_t)text >> 2) % BINLOG_SEEN_LENGTH;
+  for (unsigned int probe = 0; probe < BINLOG_SEEN_LENGTH; probe++) {
+    unsigned int slot = (index + probe) % BINLOG_SEEN_LENGTH;
+    if (seen[slot] == text)
+      return false;
+    if (seen[slot] == NULL) {
+      seen[slot] = text;
+      return true;
+    }
+  }
+  return true;
+}
+
+static void send_string(const char *text) {
+  if (!mark_seen(text))
+    return;
+  printf("#BLS %" PRIxPTR " ", (uintptr_t)text);
+  for (; *text != '\0'; text++)
+    printf("%02x", (unsigned char)*text);
+  printf("\n");
+}
+
+static void send_record(unsigned int core, const BinlogRecord *record) {
+  const char *format = record->format;
+  unsigned int next = 0;
+  char conversion;
+
+  // the decoder needs the text of the format and of all %s arguments first
+  send_string(record->format);
+  while ((conversion = binlog_next_conversion(&format)) != '\0' &&
+         next < record->count) {
+    if (conversion == 's' && record->args[next] != 0)
+      send_string((const char *)record->args[next]);
+    next++;
+  }
+
+  printf("#BLR %u %" PRIx32 " %" PRIxPTR, core, record->timestamp,
+         (uintptr_t)record->format);
+  for (unsigned int i = 0; i < record->count; i++)
+    printf(" %" PRIxPTR, (uintptr_t)record->args[i]);
+  printf("\n");
+}
+
+static void print_record(const BinlogRecord *record) {
+  char line[BINLOG_LINE_LENGTH];
+  binlog_format(line, sizeof(line), record->format, record->args,
+                record->count, sizeof(BinlogWord) * 8, string_argument, NULL);
+  printf("%s", line);
+}
+
+// Returns the number of records drained from 'core'
+static unsigned int drain_ring(unsigned int core, uint32_t *reported_drops) {
+  BinlogRing *ring = &rings[core];
+  uint32_t tail = ring->tail;
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  unsigned int drained = head - tail;
+
+  for (; tail != head; tail++) {
+    const BinlogRecord *record = &ring->records[tail % BINLOG_RING_LENGTH];
+    if (BINLOG_ENCODED_OUTPUT)
+      send_record(core, record);
+    else
+      print_record(record);
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  uint32_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+  if (dropped != *reported_drops) {
+    if (BINLOG_ENCODED_OUTPUT)
+      printf("#BLD %u %" PRIu32 "\n", core, dropped);
+    else
+      printf("BINLOG: %" PRIu32 " records of core %u dropped\n",
+             dropped - *reported_drops, core);
+    *reported_drops = dropped;
+  }
+  return drained;
+}
+
+static void drain_implementation(void *v_params) {
+  uint32_t reported_drops[portNUM_PROCESSORS] = {0};
+
+  if (BINLOG_ENCODED_OUTPUT)
+    printf("#BLH %u\n", (unsigned int)sizeof(BinlogWord) * 8);
+  while (true) {
+    unsigned int drained = 0;
+    for (unsigned int core = 0; core < portNUM_PROCESSORS; core++)
+      drained += drain_ring(core, &reported_drops[core]);
+    if (drained == 0)
+      vTaskDelay(pdMS_TO_TICKS(BINLOG_DRAIN_INTERVAL_MS));
+  }
+}
+
+bool binlog_start(UBaseType_t priority) {
+  if (drain_task != NULL)
+    return true;
+  if (xTaskCreate(drain_implementation, "binlog", BINLOG_STACK_SIZE, NULL,
+                  priority, &drain_task) != pdPASS) {
+    printf("ERROR: Could not start the log drain task\n");
+    drain_task = NULL;
+    return false;
+  }
+  return true;
+}
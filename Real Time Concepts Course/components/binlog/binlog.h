@@ -0,0 +1,62 @@
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include "binlog_format.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+
+/* If true, the drain task streams the records as '#BL' lines for the host
+ * decoder (Host/binlog). Otherwise it formats them on the device. */
+#ifndef BINLOG_ENCODED_OUTPUT
+#define BINLOG_ENCODED_OUTPUT false
+#endif
+
+#define BINLOG_MAX_ARGS 4
+#define BINLOG_RING_LENGTH 256 // records per core, a power of two
+#define BINLOG_LINE_LENGTH 160
+#define BINLOG_DRAIN_INTERVAL_MS 20
+#define BINLOG_STACK_SIZE (configMINIMAL_STACK_SIZE + 2048)
+
+/* Deferred formatting for real-time code.
+ * BINLOG(format, ...) only stores the address of the format, a timestamp
+ * and up to BINLOG_MAX_ARGS raw argument words in a ring buffer of the
+ * current core, which takes some tens of cycles instead of the milliseconds
+ * printf spends on the UART. A low priority drain task formats or streams
+ * the records later. The format has to be a string literal and every
+ * argument has to fit into a word: integers up to 32 bit, characters, and
+ * strings that stay valid until they are drained. If a ring is full, new
+ * records are dropped and counted. */
+#define BINLOG(format, ...)                                                    \
+  do {                                                                         \
+    if (0)                                                                     \
+      binlog_check_format(format, ##__VA_ARGS__);                             \
+    const BinlogWord binlog_args[] = {                                         \
+        0, BINLOG_SELECT(_, ##__VA_ARGS__, BINLOG_WORDS_4, BINLOG_WORDS_3,    \
+                         BINLOG_WORDS_2, BINLOG_WORDS_1,                       \
+                         BINLOG_WORDS_0)(__VA_ARGS__)};                        \
+    binlog_write(format, sizeof(binlog_args) / sizeof(BinlogWord) - 1,         \
+                 binlog_args + 1);                                             \
+  } while (0)
+
+#define BINLOG_SELECT(_0, _1, _2, _3, _4, words, ...) words
+#define BINLOG_WORDS_0()
+#define BINLOG_WORDS_1(a) (BinlogWord)(a)
+#define BINLOG_WORDS_2(a, b) (BinlogWord)(a), (BinlogWord)(b)
+#define BINLOG_WORDS_3(a, b, c)                                                \
+  (BinlogWord)(a), (BinlogWord)(b), (BinlogWord)(c)
+#define BINLOG_WORDS_4(a, b, c, d)                                             \
+  (BinlogWord)(a), (BinlogWord)(b), (BinlogWord)(c), (BinlogWord)(d)
+
+// only used for the compile time check of the arguments against the format
+static inline __attribute__((format(printf, 1, 2))) void
+binlog_check_format(const char *format, ...) {}
+
+void binlog_write(const char *format, unsigned int count,
+                  const BinlogWord *args);
+
+/* Start the drain task. Records written before are kept, as long as they
+ * fit into the rings. */
+bool binlog_start(UBaseType_t priority);
+
+#endif
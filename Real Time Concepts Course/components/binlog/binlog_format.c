@@ -0,0 +1,111 @@
+#include "binlog_format.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BINLOG_SPEC_LENGTH 24
+
+/* Splits the conversion at 'format' (behind the '%') into its flags, width
+ * and precision, which are copied to 'spec', and the conversion character.
+ * Length modifiers are skipped, since every argument is one word. */
+static const char *parse_conversion(const char *format, char *spec,
+                                    char *conversion) {
+  size_t length = 0;
+  spec[length++] = '%';
+  while (*format != '\0' && strchr("-+ #0123456789.", *format) != NULL) {
+    if (length < BINLOG_SPEC_LENGTH - 4)
+      spec[length++] = *format;
+    format++;
+  }
+  while (*format != '\0' && strchr("hlLqjzt", *format) != NULL)
+    format++;
+  spec[length] = '\0';
+  *conversion = *format;
+  return *format != '\0' ? format + 1 : format;
+}
+
+char binlog_next_conversion(const char **format) {
+  char spec[BINLOG_SPEC_LENGTH], conversion = '\0';
+  while (**format != '\0') {
+    if (*(*format)++ != '%')
+      continue;
+    *format = parse_conversion(*format, spec, &conversion);
+    if (conversion != '%' && conversion != '\0')
+      return conversion;
+  }
+  return '\0';
+}
+
+static long long extend_sign(BinlogWord word, unsigned int word_bits) {
+  if (word_bits >= 64)
+    return (long long)word;
+  uint64_t sign = 1ULL << (word_bits - 1);
+  uint64_t value = (uint64_t)word & ((sign << 1) - 1);
+  return (long long)((value ^ sign) - sign);
+}
+
+static unsigned long long zero_extend(BinlogWord word,
+                                      unsigned int word_bits) {
+  if (word_bits >= 64)
+    return (unsigned long long)word;
+  return (uint64_t)word & ((1ULL << word_bits) - 1);
+}
+
+int binlog_format(char *out, size_t size, const char *format,
+                  const BinlogWord *args, unsigned int count,
+                  unsigned int word_bits, BinlogStringFunction string,
+                  void *context) {
+  char spec[BINLOG_SPEC_LENGTH], conversion;
+  unsigned int next = 0;
+  size_t length = 0;
+
+  while (*format != '\0') {
+    int written;
+    if (*format != '%') {
+      written = 1;
+      if (length + 1 < size)
+        out[length] = *format;
+      format++;
+      length += written;
+      continue;
+    }
+    format = parse_conversion(format + 1, spec, &conversion);
+    char *room = length < size ? out + length : NULL;
+    size_t left = length < size ? size - length : 0;
+    if (conversion == '%') {
+      written = snprintf(room, left, "%%");
+    } else if (next >= count || conversion == '\0') {
+      written = snprintf(room, left, "<?>");
+    } else if (strchr("di", conversion) != NULL) {
+      strcat(spec, "lld");
+      written =
+          snprintf(room, left, spec, extend_sign(args[next++], word_bits));
+    } else if (strchr("uoxX", conversion) != NULL) {
+      size_t end = strlen(spec);
+      spec[end++] = 'l';
+      spec[end++] = 'l';
+      spec[end++] = conversion;
+      spec[end] = '\0';
+      written =
+          snprintf(room, left, spec, zero_extend(args[next++], word_bits));
+    } else if (conversion == 'c') {
+      strcat(spec, "c");
+      written = snprintf(room, left, spec, (int)(char)args[next++]);
+    } else if (conversion == 'p') {
+      written = snprintf(room, left, "0x%llx",
+                         zero_extend(args[next++], word_bits));
+    } else if (conversion == 's') {
+      const char *text = string != NULL ? string(args[next], context) : NULL;
+      next++;
+      strcat(spec, "s");
+      written = snprintf(room, left, spec, text != NULL ? text : "<?>");
+    } else {
+      next++;
+      written = snprintf(room, left, "<?>");
+    }
+    length += written > 0 ? written : 0;
+  }
+
+  if (size > 0)
+    out[length < size ? length : size - 1] = '\0';
+  return length;
+}
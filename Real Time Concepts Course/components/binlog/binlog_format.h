@@ -0,0 +1,30 @@
+#ifndef BINLOG_FORMAT_H
+#define BINLOG_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// raw argument of a log record, wide enough for integers and pointers
+typedef uintptr_t BinlogWord;
+
+// Returns the text of a %s argument, or NULL if it is unknown
+typedef const char *(*BinlogStringFunction)(BinlogWord address,
+                                            void *context);
+
+/* Printf style formatting of recorded arguments, shared by the drain task
+ * and the host decoder. Supported are the integer conversions (d, i, u, o,
+ * x, X, c, p) with flags, width, precision and length modifiers, and %s via
+ * 'string'. Every conversion takes one word; 'word_bits' is the word size of
+ * the system that recorded the arguments, so signed values are extended
+ * correctly. Other conversions print "<?>". Returns the length like
+ * snprintf. */
+int binlog_format(char *out, size_t size, const char *format,
+                  const BinlogWord *args, unsigned int count,
+                  unsigned int word_bits, BinlogStringFunction string,
+                  void *context);
+
+/* Advances '*format' behind the next conversion that takes an argument and
+ * returns its conversion character, or '\0' at the end of the format. */
+char binlog_next_conversion(const char **format);
+
+#endif
@@ -0,0 +1,122 @@
+#include "cyclestat.h"
+
+#if CYCLESTAT_ENABLED
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#define SUB_BUCKETS (1U << CYCLESTAT_SUB_BUCKET_BITS)
+
+static CycleSite *sites[CYCLESTAT_MAX_SITES];
+static uint32_t site_count;
+static TaskHandle_t report_task = NULL;
+
+/* Values below SUB_BUCKETS have a bucket of their own. Above, the bucket is
+ * given by the position of the leading one and the next
+ * CYCLESTAT_SUB_BUCKET_BITS bits. */
+static unsigned int bucket_of(uint32_t cycles) {
+  if (cycles < SUB_BUCKETS)
+    return cycles;
+  unsigned int exponent = 31 - __builtin_clz(cycles);
+  unsigned int shift = exponent - CYCLESTAT_SUB_BUCKET_BITS;
+  return ((shift + 1) << CYCLESTAT_SUB_BUCKET_BITS) +
+         ((cycles >> shift) & (SUB_BUCKETS - 1));
+}
+
+// largest value that falls into 'bucket'
+static uint32_t bucket_limit(unsigned int bucket) {
+  if (bucket < SUB_BUCKETS)
+    return bucket;
+  unsigned int shift = (bucket >> CYCLESTAT_SUB_BUCKET_BITS) - 1;
+  uint32_t first = (SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << shift;
+  return first + ((1U << shift) - 1);
+}
+
+static void register_site(CycleSite *site) {
+  bool expected = false;
+  if (!__atomic_compare_exchange_n(&site->registered, &expected, true, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    return;
+  uint32_t index = __atomic_fetch_add(&site_count, 1, __ATOMIC_RELAXED);
+  if (index < CYCLESTAT_MAX_SITES)
+    __atomic_store_n(&sites[index], site, __ATOMIC_RELEASE);
+}
+
+void cyclestat_record(CycleSite *site, uint32_t cycles) {
+  if (!__atomic_load_n(&site->registered, __ATOMIC_ACQUIRE))
+    register_site(site);
+  __atomic_fetch_add(&site->buckets[bucket_of(cycles)], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&site->count, 1, __ATOMIC_RELAXED);
+  // only retries while another core raises the maximum at the same time
+  uint32_t max = __atomic_load_n(&site->max, __ATOMIC_RELAXED);
+  while (cycles > max &&
+         !__atomic_compare_exchange_n(&site->max, &max, cycles, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+// smallest bucket limit that at least 'permille' of 'count' samples are in
+static uint32_t percentile(const uint32_t *buckets, uint32_t count,
+                           uint32_t max, unsigned int permille) {
+  uint64_t rank = ((uint64_t)count * permille + 999) / 1000;
+  uint64_t seen = 0;
+  for (unsigned int bucket = 0; bucket < CYCLESTAT_BUCKETS; bucket++) {
+    seen += buckets[bucket];
+    if (seen >= rank && seen > 0)
+      return bucket_limit(bucket) < max ? bucket_limit(bucket) : max;
+  }
+  return max;
+}
+
+void cyclestat_report() {
+  static uint32_t buckets[CYCLESTAT_BUCKETS];
+  uint32_t registered = __atomic_load_n(&site_count, __ATOMIC_RELAXED);
+  if (registered > CYCLESTAT_MAX_SITES) {
+    printf("ERROR: %" PRIu32 " cycle statistics sites, only %u are kept\n",
+           registered, CYCLESTAT_MAX_SITES);
+    registered = CYCLESTAT_MAX_SITES;
+  }
+
+  printf("%-20s %10s %10s %10s %10s\n", "cycles", "count", "p50", "p99",
+         "max");
+  for (uint32_t i = 0; i < registered; i++) {
+    CycleSite *site = __atomic_load_n(&sites[i], __ATOMIC_ACQUIRE);
+    if (site == NULL)
+      continue;
+    // the snapshot may be a few samples behind while sites are recording
+    uint32_t count = 0;
+    for (unsigned int bucket = 0; bucket < CYCLESTAT_BUCKETS; bucket++) {
+      buckets[bucket] =
+          __atomic_load_n(&site->buckets[bucket], __ATOMIC_RELAXED);
+      count += buckets[bucket];
+    }
+    uint32_t max = __atomic_load_n(&site->max, __ATOMIC_RELAXED);
+    printf("%-20s %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+           site->name, count, percentile(buckets, count, max, 500),
+           percentile(buckets, count, max, 990), max);
+  }
+}
+
+static void report_implementation(void *v_interval_ms) {
+  TickType_t interval = pdMS_TO_TICKS((uintptr_t)v_interval_ms);
+  TickType_t last_wake_time = xTaskGetTickCount();
+  while (true) {
+    vTaskDelayUntil(&last_wake_time, interval);
+    cyclestat_report();
+  }
+}
+
+bool cyclestat_start(UBaseType_t priority, uint32_t interval_ms) {
+  if (report_task != NULL)
+    return true;
+  if (xTaskCreate(report_implementation, "cyclestat", CYCLESTAT_STACK_SIZE,
+                  (void *)(uintptr_t)interval_ms, priority,
+                  &report_task) != pdPASS) {
+    printf("ERROR: Could not start the cycle statistics report task\n");
+    report_task = NULL;
+    return false;
+  }
+  return true;
+}
+
+#endif
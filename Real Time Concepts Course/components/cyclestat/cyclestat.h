@@ -0,0 +1,85 @@
+#ifndef CYCLESTAT_H
+#define CYCLESTAT_H
+
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* If false, the CYCLESTAT macros only leave the measured statements behind
+ * and neither code nor memory is spent on the histograms. */
+#ifndef CYCLESTAT_ENABLED
+#define CYCLESTAT_ENABLED false
+#endif
+
+// 2^3 buckets per power of two, i.e., a bucket is at most 12.5% wide
+#define CYCLESTAT_SUB_BUCKET_BITS 3
+#define CYCLESTAT_BUCKETS                                                      \
+  ((32 - CYCLESTAT_SUB_BUCKET_BITS + 1) << CYCLESTAT_SUB_BUCKET_BITS)
+#define CYCLESTAT_MAX_SITES 16
+#define CYCLESTAT_STACK_SIZE (configMINIMAL_STACK_SIZE + 1024)
+
+/* Cost of code paths in CPU cycles (nanoseconds on the host).
+ * Every call site has a fixed size log-linear histogram. Recording a sample
+ * takes a count of leading zeros and three atomic updates, whatever the
+ * number of samples, and may run on both cores. Measured spans include
+ * preemptions and interrupts, which shows in the maximum.
+ *
+ *   CYCLESTAT_SITE(select_site, "edf_select");
+ *   ...
+ *   CYCLESTAT_MEASURE(select_site, info = edf_select_next_job(...));
+ *
+ * A site registers itself with its first sample; cyclestat_report prints
+ * count, p50, p99 and max of all registered sites. */
+typedef struct {
+  const char *name;
+  bool registered;
+  uint32_t count;
+  uint32_t max;
+  uint32_t buckets[CYCLESTAT_BUCKETS];
+} CycleSite;
+
+#if CYCLESTAT_ENABLED
+
+#define CYCLESTAT_SITE(site, site_name)                                        \
+  static CycleSite site = {.name = site_name}
+#define CYCLESTAT_MEASURE(site, statement)                                     \
+  do {                                                                         \
+    uint32_t cyclestat_start = esp_cpu_get_cycle_count();                      \
+    statement;                                                                 \
+    cyclestat_record(&site, esp_cpu_get_cycle_count() - cyclestat_start);      \
+  } while (0)
+// for spans that are not a single statement
+#define CYCLESTAT_BEGIN(span) uint32_t span = esp_cpu_get_cycle_count()
+#define CYCLESTAT_RESTART(span) span = esp_cpu_get_cycle_count()
+#define CYCLESTAT_END(site, span)                                              \
+  cyclestat_record(&site, esp_cpu_get_cycle_count() - span)
+
+void cyclestat_record(CycleSite *site, uint32_t cycles);
+
+// print all registered sites
+void cyclestat_report();
+
+/* Start a task that calls cyclestat_report every 'interval_ms'. */
+bool cyclestat_start(UBaseType_t priority, uint32_t interval_ms);
+
+#else
+
+#define CYCLESTAT_SITE(site, site_name) extern CycleSite site
+#define CYCLESTAT_MEASURE(site, statement)                                     \
+  do {                                                                         \
+    statement;                                                                 \
+  } while (0)
+#define CYCLESTAT_BEGIN(span)
+#define CYCLESTAT_RESTART(span)
+#define CYCLESTAT_END(site, span)
+
+static inline void cyclestat_report() {}
+static inline bool cyclestat_start(UBaseType_t priority, uint32_t interval_ms) {
+  return false;
+}
+
+#endif
+
+#endif
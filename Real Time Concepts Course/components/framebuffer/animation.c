@@ -0,0 +1,107 @@
+#include "animation.h"
+#include <string.h>
+
+static const uint8_t blank_page[FRAMEBUFFER_WIDTH] = {0};
+
+void animation_init(Animation *animation, uint8_t *buffer, uint16_t capacity) {
+  animation->data = buffer;
+  animation->size = 0;
+  animation->capacity = capacity;
+  animation->offsets[0] = 0;
+  animation->frames = 0;
+  animation->shown_frame = -1;
+}
+
+/* Runs never cross a page and a gap of at most two unchanged bytes is
+ * included in the run, since a new run costs two header bytes. */
+static bool encode_page(Animation *animation, const uint8_t *previous,
+                        const uint8_t *next, uint16_t *skip) {
+  int column = 0;
+
+  while (column < FRAMEBUFFER_WIDTH) {
+    if (previous[column] == next[column]) {
+      column++;
+      (*skip)++;
+      continue;
+    }
+    int first = column, last = column;
+    for (column++; column < FRAMEBUFFER_WIDTH && column - last <= 3 &&
+                   column - first < UINT8_MAX;
+         column++) {
+      if (previous[column] != next[column])
+        last = column;
+    }
+    column = last + 1;
+
+    // skips that do not fit into a header byte are split into empty runs
+    uint16_t length = last - first + 1;
+    uint16_t headers = 2 * (*skip / UINT8_MAX + 1);
+    if (animation->size + headers + length > animation->capacity)
+      return false;
+    while (*skip >= UINT8_MAX) {
+      animation->data[animation->size++] = UINT8_MAX;
+      animation->data[animation->size++] = 0;
+      *skip -= UINT8_MAX;
+    }
+    animation->data[animation->size++] = *skip;
+    animation->data[animation->size++] = length;
+    memcpy(&animation->data[animation->size], &next[first], length);
+    animation->size += length;
+    *skip = 0;
+  }
+  return true;
+}
+
+bool animation_add_frame(Animation *animation,
+                         const uint8_t (*previous)[FRAMEBUFFER_WIDTH],
+                         const uint8_t (*frame)[FRAMEBUFFER_WIDTH]) {
+  uint16_t skip = 0, size = animation->size;
+
+  if (animation->frames == ANIMATION_MAX_FRAMES)
+    return false;
+  for (uint8_t page = 0; page < FRAMEBUFFER_PAGES; page++) {
+    if (!encode_page(animation, previous != NULL ? previous[page] : blank_page,
+                     frame[page], &skip)) {
+      animation->size = size;
+      return false;
+    }
+  }
+  animation->offsets[++animation->frames] = animation->size;
+  return true;
+}
+
+static void apply_delta(Animation *animation, Framebuffer *fb,
+                        unsigned int frame) {
+  const uint8_t *data = &animation->data[animation->offsets[frame]];
+  const uint8_t *end = &animation->data[animation->offsets[frame + 1]];
+  uint16_t position = 0;
+
+  while (data < end) {
+    position += data[0];
+    uint8_t length = data[1];
+    if (length > 0) {
+      framebuffer_write_page(fb, position / FRAMEBUFFER_WIDTH,
+                             position % FRAMEBUFFER_WIDTH, &data[2], length);
+    }
+    position += length;
+    data += 2 + length;
+  }
+}
+
+void animation_show_frame(Animation *animation, Framebuffer *fb,
+                          unsigned int frame) {
+  if (frame >= animation->frames)
+    return;
+  if (animation->shown_frame < 0 ||
+      frame != (unsigned int)animation->shown_frame + 1) {
+    framebuffer_clear(fb);
+    for (unsigned int i = 0; i < frame; i++)
+      apply_delta(animation, fb, i);
+  }
+  apply_delta(animation, fb, frame);
+  animation->shown_frame = frame;
+}
+
+void animation_invalidate(Animation *animation) {
+  animation->shown_frame = -1;
+}
@@ -0,0 +1,39 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "framebuffer.h"
+
+#define ANIMATION_MAX_FRAMES 16
+
+/* Cache of pre-rendered, compressed animation frames.
+ * Every frame is stored as the delta to its predecessor (the first one to
+ * a blank display) in the native page layout of the framebuffer: a list of
+ * runs (skip, length, bytes) over the 1 KB of pixels, so unchanged bytes
+ * cost nothing. Playing the next frame only copies its changed bytes into
+ * the framebuffer, and the following flush only sends these. */
+typedef struct {
+  uint8_t *data;
+  uint16_t size;
+  uint16_t capacity;
+  uint16_t offsets[ANIMATION_MAX_FRAMES + 1]; // frame i is [i, i + 1)
+  unsigned int frames;
+  int shown_frame; // frame in the framebuffer, -1 if unknown
+} Animation;
+
+/* The encoded frames are stored in 'buffer' of 'capacity' bytes. */
+void animation_init(Animation *animation, uint8_t *buffer, uint16_t capacity);
+
+/* Append 'frame', given the pixels of the previous frame (NULL for the
+ * first one). Returns false if the frame does not fit. */
+bool animation_add_frame(Animation *animation,
+                         const uint8_t (*previous)[FRAMEBUFFER_WIDTH],
+                         const uint8_t (*frame)[FRAMEBUFFER_WIDTH]);
+
+/* Decode 'frame' into the framebuffer. Consecutive frames only apply the
+ * delta, any other frame is rebuilt from a cleared framebuffer. Call
+ * animation_invalidate if anything else was drawn in the meantime. */
+void animation_show_frame(Animation *animation, Framebuffer *fb,
+                          unsigned int frame);
+void animation_invalidate(Animation *animation);
+
+#endif
@@ -0,0 +1,15 @@
+#include "display_server.h"
+#include <inttypes.h>
+#include <stdio.h>
+
+esp_err_t display_server_flush(Framebuffer *fb) {
+  esp_err_t ret = framebuffer_flush(fb);
+  if (DISPLAY_SERVER_TRAFFIC_REPORT) {
+    DisplayServerStats stats = display_server_stats();
+    printf("DISPLAY: %" PRIu32 " bytes in %" PRIu32 " segments (avg %" PRIu64
+           " bytes/frame), %" PRIu32 " of %" PRIu32 " updates superseded\n",
+           fb->last_frame.bytes, fb->last_frame.segments,
+           fb->total_bytes / fb->frames, stats.superseded, stats.posted);
+  }
+  return ret;
+}
@@ -0,0 +1,81 @@
+#include "display_server.h"
+#include <stdio.h>
+
+typedef struct {
+  QueueHandle_t queue;
+  DisplayRenderFunction render;
+  void *snapshot; // newest snapshot, owned by the server task
+  TickType_t frame_interval;
+  DisplayServerStats stats;
+} DisplayServer;
+
+static DisplayServer server = {.queue = NULL};
+
+static void display_server_task(void *arg) {
+  TickType_t last_frame = xTaskGetTickCount() - server.frame_interval;
+
+  for (;;) {
+    xQueueReceive(server.queue, server.snapshot, portMAX_DELAY);
+
+    // limit the frame rate, snapshots posted in the meantime replace this one
+    TickType_t since_last_frame = xTaskGetTickCount() - last_frame;
+    if (since_last_frame < server.frame_interval)
+      vTaskDelay(server.frame_interval - since_last_frame);
+    uint32_t superseded = 0;
+    while (xQueueReceive(server.queue, server.snapshot, 0) == pdTRUE)
+      superseded++;
+
+    last_frame = xTaskGetTickCount();
+    server.render(server.snapshot);
+
+    vTaskSuspendAll();
+    server.stats.superseded += superseded;
+    server.stats.rendered++;
+    xTaskResumeAll();
+  }
+}
+
+bool display_server_start(DisplayRenderFunction render, size_t snapshot_size,
+                          UBaseType_t priority, TickType_t frame_interval) {
+  server.render = render;
+  server.frame_interval = frame_interval;
+  server.stats = (DisplayServerStats){0, 0, 0};
+  server.snapshot = pvPortMalloc(snapshot_size);
+  server.queue = xQueueCreate(DISPLAY_SERVER_QUEUE_LENGTH, snapshot_size);
+  if (server.snapshot == NULL || server.queue == NULL) {
+    printf("ERROR: Could not allocate the display server queue\n");
+    return false;
+  }
+
+  if (xTaskCreate(display_server_task, "display", DISPLAY_SERVER_STACK_SIZE,
+                  NULL, priority, NULL) != pdPASS) {
+    printf("ERROR: Could not create the display server\n");
+    vQueueDelete(server.queue);
+    server.queue = NULL;
+    return false;
+  }
+  return true;
+}
+
+bool display_server_post(const void *snapshot) {
+  if (server.queue == NULL)
+    return false;
+
+  // the scheduler is suspended, so posters cannot reorder their snapshots
+  vTaskSuspendAll();
+  if (uxQueueSpacesAvailable(server.queue) == 0) {
+    server.stats.superseded += uxQueueMessagesWaiting(server.queue);
+    xQueueReset(server.queue);
+  }
+  xQueueSend(server.queue, snapshot, 0);
+  server.stats.posted++;
+  xTaskResumeAll();
+  return true;
+}
+
+DisplayServerStats display_server_stats() {
+  vTaskSuspendAll();
+  DisplayServerStats stats = server.stats;
+  xTaskResumeAll();
+  return stats;
+}
@@ -0,0 +1,54 @@
+#ifndef DISPLAY_SERVER_H
+#define DISPLAY_SERVER_H
+
+#include "framebuffer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#define DISPLAY_SERVER_QUEUE_LENGTH 4
+#define DISPLAY_SERVER_STACK_SIZE (configMINIMAL_STACK_SIZE + 1024)
+
+// default priority of the server task, below all real-time tasks
+#ifndef DISPLAY_SERVER_PRIORITY
+#define DISPLAY_SERVER_PRIORITY tskIDLE_PRIORITY
+#endif
+
+/* Print the bus traffic of every flush of display_server_flush. Off by
+ * default, the printf blocks on the UART. To turn it on, define it for the
+ * whole build in the project CMakeLists.txt:
+ *   idf_build_set_property(COMPILE_DEFINITIONS
+ *                          "-DDISPLAY_SERVER_TRAFFIC_REPORT=true" APPEND) */
+#ifndef DISPLAY_SERVER_TRAFFIC_REPORT
+#define DISPLAY_SERVER_TRAFFIC_REPORT false
+#endif
+
+/* Draws and flushes a frame for a snapshot. Only called by the server. */
+typedef void (*DisplayRenderFunction)(const void *snapshot);
+
+typedef struct {
+  uint32_t posted;
+  uint32_t superseded; // dropped because a newer snapshot arrived in time
+  uint32_t rendered;
+} DisplayServerStats;
+
+/* Asynchronous display updates.
+ * The server task is the only one that renders, i.e., that talks to the
+ * I2C bus, and should run below all real-time tasks. These only post a copy
+ * of the state to display into a bounded queue and never wait: if the queue
+ * is full, the new snapshot supersedes all queued ones. The server renders
+ * at most one frame per 'frame_interval' ticks, always for the newest
+ * snapshot; older ones that are still queued are superseded. */
+bool display_server_start(DisplayRenderFunction render, size_t snapshot_size,
+                          UBaseType_t priority, TickType_t frame_interval);
+
+/* Non-blocking; returns false if the server is not running. */
+bool display_server_post(const void *snapshot);
+
+DisplayServerStats display_server_stats();
+
+/* Flush 'fb' at the end of a render function, see
+ * DISPLAY_SERVER_TRAFFIC_REPORT. */
+esp_err_t display_server_flush(Framebuffer *fb);
+
+#endif
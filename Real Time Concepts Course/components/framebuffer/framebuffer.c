@@ -0,0 +1,226 @@
+#include "framebuffer.h"
+#include "freertos/FreeRTOS.h"
+#include "ssd1306_fonts.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRAMEBUFFER_CONTROL_COMMAND 0x00
+#define FRAMEBUFFER_CONTROL_DATA 0x40
+#define FRAMEBUFFER_I2C_TIMEOUT_MS 100
+
+static esp_err_t framebuffer_transfer(Framebuffer *fb, uint8_t control,
+                                      const uint8_t *data, size_t length) {
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (fb->address << 1) | I2C_MASTER_WRITE, true);
+  i2c_master_write_byte(cmd, control, true);
+  i2c_master_write(cmd, data, length, true);
+  i2c_master_stop(cmd);
+  esp_err_t ret = i2c_master_cmd_begin(
+      fb->port, cmd, pdMS_TO_TICKS(FRAMEBUFFER_I2C_TIMEOUT_MS));
+  i2c_cmd_link_delete(cmd);
+
+  fb->last_frame.bytes += length + 2;
+  fb->last_frame.transactions++;
+  return ret;
+}
+
+static void mark_dirty(Framebuffer *fb, uint8_t page, uint8_t column) {
+  if (fb->dirty_first[page] > fb->dirty_last[page]) {
+    fb->dirty_first[page] = column;
+    fb->dirty_last[page] = column;
+  } else if (column < fb->dirty_first[page]) {
+    fb->dirty_first[page] = column;
+  } else if (column > fb->dirty_last[page]) {
+    fb->dirty_last[page] = column;
+  }
+}
+
+static void mark_clean(Framebuffer *fb, uint8_t page) {
+  fb->dirty_first[page] = FRAMEBUFFER_WIDTH - 1;
+  fb->dirty_last[page] = 0;
+}
+
+esp_err_t framebuffer_init(Framebuffer *fb, i2c_port_t port, uint8_t address) {
+  // horizontal addressing, window over the whole panel
+  const uint8_t setup[] = {0x20, 0x00, 0x21, 0, FRAMEBUFFER_WIDTH - 1,
+                           0x22, 0, FRAMEBUFFER_PAGES - 1};
+
+  memset(fb, 0, sizeof(Framebuffer));
+  fb->port = port;
+  fb->address = address;
+  framebuffer_invalidate(fb);
+
+  esp_err_t ret = framebuffer_transfer(fb, FRAMEBUFFER_CONTROL_COMMAND, setup,
+                                       sizeof(setup));
+  if (ret != ESP_OK) {
+    printf("ERROR: Could not set up the display (%d)\n", ret);
+  }
+  fb->last_frame = (FramebufferStats){0, 0, 0};
+  return ret;
+}
+
+void framebuffer_clear(Framebuffer *fb) {
+  for (uint8_t page = 0; page < FRAMEBUFFER_PAGES; page++) {
+    uint8_t first = 0, last = FRAMEBUFFER_WIDTH - 1;
+    while (first <= last && fb->pixels[page][first] == 0)
+      first++;
+    if (first > last)
+      continue;
+    while (fb->pixels[page][last] == 0)
+      last--;
+    memset(&fb->pixels[page][first], 0, last - first + 1);
+    mark_dirty(fb, page, first);
+    mark_dirty(fb, page, last);
+  }
+}
+
+void framebuffer_fill_point(Framebuffer *fb, uint8_t x, uint8_t y, bool on) {
+  if (x >= FRAMEBUFFER_WIDTH || y >= FRAMEBUFFER_HEIGHT) {
+    return;
+  }
+  // same layout as ssd1306_fill_point, the top row is the MSB of page 7
+  uint8_t page = FRAMEBUFFER_PAGES - 1 - y / 8;
+  uint8_t mask = 1 << (7 - y % 8);
+  uint8_t old = fb->pixels[page][x];
+
+  fb->pixels[page][x] = on ? old | mask : old & ~mask;
+  if (fb->pixels[page][x] != old) {
+    mark_dirty(fb, page, x);
+  }
+}
+
+void framebuffer_draw_char(Framebuffer *fb, uint8_t x, uint8_t y, char chr,
+                           uint8_t size, bool on) {
+  uint8_t y0 = y;
+  uint8_t bytes = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2);
+
+  if (chr < ' ' || chr > '~' || (size != 12 && size != 16)) {
+    return;
+  }
+  for (uint8_t i = 0; i < bytes; i++) {
+    uint8_t column = size == 12 ? c_chFont1206[chr - ' '][i]
+                                : c_chFont1608[chr - ' '][i];
+    for (uint8_t j = 0; j < 8; j++) {
+      framebuffer_fill_point(fb, x, y, (column & 0x80) ? on : !on);
+      column <<= 1;
+      y++;
+      if (y - y0 == size) {
+        y = y0;
+        x++;
+        break;
+      }
+    }
+  }
+}
+
+void framebuffer_draw_string(Framebuffer *fb, uint8_t x, uint8_t y,
+                             const char *str, uint8_t size, bool on) {
+  for (; *str != '\0'; str++) {
+    if (x > FRAMEBUFFER_WIDTH - size / 2) {
+      x = 0;
+      y += size;
+      if (y > FRAMEBUFFER_HEIGHT - size) {
+        y = x = 0;
+        framebuffer_clear(fb);
+      }
+    }
+    framebuffer_draw_char(fb, x, y, *str, size, on);
+    x += size / 2;
+  }
+}
+
+void framebuffer_draw_bitmap(Framebuffer *fb, uint8_t x, uint8_t y,
+                             const uint8_t *bitmap, uint8_t width,
+                             uint8_t height) {
+  uint16_t row_bytes = (width + 7) / 8;
+
+  for (uint16_t j = 0; j < height; j++) {
+    for (uint16_t i = 0; i < width; i++) {
+      if (bitmap[j * row_bytes + i / 8] & (0x80 >> (i % 8))) {
+        framebuffer_fill_point(fb, x + i, y + j, true);
+      }
+    }
+  }
+}
+
+void framebuffer_write_page(Framebuffer *fb, uint8_t page, uint8_t column,
+                            const uint8_t *bytes, uint8_t length) {
+  if (page >= FRAMEBUFFER_PAGES || column >= FRAMEBUFFER_WIDTH ||
+      length == 0) {
+    return;
+  }
+  if (length > FRAMEBUFFER_WIDTH - column) {
+    length = FRAMEBUFFER_WIDTH - column;
+  }
+  memcpy(&fb->pixels[page][column], bytes, length);
+  mark_dirty(fb, page, column);
+  mark_dirty(fb, page, column + length - 1);
+}
+
+void framebuffer_invalidate(Framebuffer *fb) {
+  fb->shown_valid = false;
+  for (uint8_t page = 0; page < FRAMEBUFFER_PAGES; page++) {
+    mark_dirty(fb, page, 0);
+    mark_dirty(fb, page, FRAMEBUFFER_WIDTH - 1);
+  }
+}
+
+static bool column_changed(Framebuffer *fb, uint8_t page, uint8_t column) {
+  return !fb->shown_valid ||
+         fb->pixels[page][column] != fb->shown[page][column];
+}
+
+static esp_err_t send_segment(Framebuffer *fb, uint8_t page, uint8_t first,
+                              uint8_t last) {
+  const uint8_t window[] = {0x21, first, last, 0x22, page, page};
+
+  esp_err_t ret = framebuffer_transfer(fb, FRAMEBUFFER_CONTROL_COMMAND, window,
+                                       sizeof(window));
+  if (ret == ESP_OK) {
+    ret = framebuffer_transfer(fb, FRAMEBUFFER_CONTROL_DATA,
+                               &fb->pixels[page][first], last - first + 1);
+  }
+  if (ret == ESP_OK) {
+    memcpy(&fb->shown[page][first], &fb->pixels[page][first],
+           last - first + 1);
+  }
+  fb->last_frame.segments++;
+  return ret;
+}
+
+esp_err_t framebuffer_flush(Framebuffer *fb) {
+  esp_err_t ret = ESP_OK;
+
+  fb->last_frame = (FramebufferStats){0, 0, 0};
+  for (uint8_t page = 0; page < FRAMEBUFFER_PAGES && ret == ESP_OK; page++) {
+    int column = fb->dirty_first[page], end = fb->dirty_last[page];
+
+    while (column <= end && ret == ESP_OK) {
+      if (!column_changed(fb, page, column)) {
+        column++;
+        continue;
+      }
+      // extend the segment over unchanged gaps that are cheaper to resend
+      int first = column, last = column;
+      for (column++; column <= end && column - last <= FRAMEBUFFER_MERGE_GAP;
+           column++) {
+        if (column_changed(fb, page, column))
+          last = column;
+      }
+      ret = send_segment(fb, page, first, last);
+      column = last + 1;
+    }
+    if (ret == ESP_OK)
+      mark_clean(fb, page);
+  }
+
+  if (ret == ESP_OK) {
+    fb->shown_valid = true;
+  } else {
+    printf("ERROR: Display flush failed (%d)\n", ret);
+  }
+  fb->total_bytes += fb->last_frame.bytes;
+  fb->frames++;
+  return ret;
+}
@@ -0,0 +1,71 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "driver/i2c.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FRAMEBUFFER_WIDTH 128
+#define FRAMEBUFFER_PAGES 8
+#define FRAMEBUFFER_HEIGHT (8 * FRAMEBUFFER_PAGES)
+
+/* Changed columns of a page that are at most this many columns apart are
+ * sent as one segment: a separate segment costs two more transactions with
+ * 10 bytes of address, control and window commands. */
+#define FRAMEBUFFER_MERGE_GAP 10
+
+/* Bus traffic of a flush. Bytes include the address and control bytes. */
+typedef struct {
+  uint32_t bytes;
+  uint32_t transactions;
+  uint32_t segments;
+} FramebufferStats;
+
+/* Shadow framebuffer for an SSD1306 on the legacy I2C driver.
+ * Drawing only touches 'pixels' and widens the dirty column range of the
+ * touched pages. framebuffer_flush compares the dirty ranges against
+ * 'shown', the content of the panel, and only sends the 8 pixel high page
+ * segments that actually changed. The pixel layout is the one of the
+ * espressif/ssd1306 driver, so both can be used for the same panel. */
+typedef struct {
+  i2c_port_t port;
+  uint8_t address;
+  uint8_t pixels[FRAMEBUFFER_PAGES][FRAMEBUFFER_WIDTH];
+  uint8_t shown[FRAMEBUFFER_PAGES][FRAMEBUFFER_WIDTH];
+  uint8_t dirty_first[FRAMEBUFFER_PAGES]; // > dirty_last if page is clean
+  uint8_t dirty_last[FRAMEBUFFER_PAGES];
+  bool shown_valid; // false until the whole panel has been written once
+  FramebufferStats last_frame;
+  uint64_t total_bytes;
+  uint32_t frames;
+} Framebuffer;
+
+/* Switch the panel to horizontal addressing, which the segment windows rely
+ * on. The panel itself has to be initialized already, e.g. by
+ * ssd1306_create. The first flush writes the whole panel. */
+esp_err_t framebuffer_init(Framebuffer *fb, i2c_port_t port, uint8_t address);
+
+void framebuffer_clear(Framebuffer *fb);
+void framebuffer_fill_point(Framebuffer *fb, uint8_t x, uint8_t y, bool on);
+
+/* Same semantics as the ssd1306_draw_* functions; 'size' is 12 or 16. */
+void framebuffer_draw_char(Framebuffer *fb, uint8_t x, uint8_t y, char chr,
+                           uint8_t size, bool on);
+void framebuffer_draw_string(Framebuffer *fb, uint8_t x, uint8_t y,
+                             const char *str, uint8_t size, bool on);
+void framebuffer_draw_bitmap(Framebuffer *fb, uint8_t x, uint8_t y,
+                             const uint8_t *bitmap, uint8_t width,
+                             uint8_t height);
+
+/* Copy bytes in the native page layout to 'page', starting at 'column'. */
+void framebuffer_write_page(Framebuffer *fb, uint8_t page, uint8_t column,
+                            const uint8_t *bytes, uint8_t length);
+
+/* Forget the content of the panel, the next flush rewrites all of it. */
+void framebuffer_invalidate(Framebuffer *fb);
+
+/* Send the changed segments. The traffic of this flush is stored in
+ * fb->last_frame. */
+esp_err_t framebuffer_flush(Framebuffer *fb);
+
+#endif
@@ -0,0 +1,34 @@
+#include "workload.h"
+
+/* Execution time distributions of workload.h. They do not depend on the
+ * kernels, so the simulator of the host reuses them. */
+
+// xorshift32, never returns 0
+static uint32_t next_random(uint32_t *seed) {
+  uint32_t x = *seed != 0 ? *seed : 1;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *seed = x;
+}
+
+uint64_t workload_sample(WorkloadDistribution distribution, uint64_t cycles,
+                         uint32_t *seed) {
+  uint64_t best_case = cycles * WORKLOAD_BEST_CASE_PERMILLE / 1000;
+  uint32_t draw;
+  switch (distribution) {
+  case WORKLOAD_UNIFORM:
+    draw = next_random(seed);
+    break;
+  case WORKLOAD_TRIANGULAR: {
+    // the smaller of two uniform draws has a linearly falling density
+    uint32_t first = next_random(seed), second = next_random(seed);
+    draw = first < second ? first : second;
+    break;
+  }
+  default:
+    return cycles;
+  }
+  // 24 bits of the draw keep the product in range for hours of cycles
+  return best_case + (((cycles - best_case) * (draw >> 8)) >> 24);
+}
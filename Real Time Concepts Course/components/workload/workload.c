@@ -0,0 +1,122 @@
+#include "workload.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <stdio.h>
+
+#define MEMORY_WORDS (WORKLOAD_MEMORY_BYTES / sizeof(uint32_t))
+#define LINE_WORDS (WORKLOAD_CACHE_LINE / sizeof(uint32_t))
+#define CACHE_LINES (WORKLOAD_CACHE_BYTES / WORKLOAD_CACHE_LINE)
+/* Lines between two reads of WORKLOAD_CACHE. Being odd, it visits every
+ * line once per CACHE_LINES reads, and not in an order that prefetching
+ * could follow. */
+#define CACHE_STEP 97
+// fixed point of the cost of an iteration
+#define COST_SHIFT 8
+
+static const char *kernel_names[WORKLOAD_KERNELS] = {"cpu", "memory",
+                                                     "cache"};
+// cycles per iteration << COST_SHIFT
+static uint32_t iteration_cost[WORKLOAD_KERNELS];
+static uint32_t cycles_per_us = 1;
+
+// keeps the results of the kernels alive, races between cores do not matter
+static volatile uint32_t sink;
+static uint32_t memory_buffer[MEMORY_WORDS];
+// not zero, so the table is placed in flash and not in .bss
+static const uint32_t cache_table[WORKLOAD_CACHE_BYTES / sizeof(uint32_t)] = {
+    [0 ...(WORKLOAD_CACHE_BYTES / sizeof(uint32_t) - 1)] = 0x9e3779b9};
+
+static void cpu_kernel(uint32_t iterations) {
+  uint32_t x = sink;
+  for (uint32_t i = 0; i < iterations; i++)
+    x = x * 1664525 + 1013904223;
+  sink = x;
+}
+
+// one half of the buffer is copied into the other, a line per iteration
+static void memory_kernel(uint32_t iterations) {
+  unsigned int line = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    uint32_t *source = &memory_buffer[line * LINE_WORDS];
+    uint32_t *destination = source + MEMORY_WORDS / 2;
+    for (unsigned int word = 0; word < LINE_WORDS; word++)
+      destination[word] = source[word] + i;
+    line = line + 1 < MEMORY_WORDS / 2 / LINE_WORDS ? line + 1 : 0;
+  }
+  sink = memory_buffer[MEMORY_WORDS - 1];
+}
+
+static void cache_kernel(uint32_t iterations) {
+  // the compiler must not fold the reads of the constant table
+  const volatile uint32_t *table = cache_table;
+  unsigned int line = 0;
+  uint32_t x = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    x += table[line * LINE_WORDS];
+    line = (line + CACHE_STEP) % CACHE_LINES;
+  }
+  sink = x;
+}
+
+static void run_iterations(WorkloadKernel kernel, uint32_t iterations) {
+  switch (kernel) {
+  case WORKLOAD_CPU:
+    cpu_kernel(iterations);
+    break;
+  case WORKLOAD_MEMORY:
+    memory_kernel(iterations);
+    break;
+  case WORKLOAD_CACHE:
+    cache_kernel(iterations);
+    break;
+  default:
+    break;
+  }
+}
+
+void workload_calibrate() {
+  // cycles per microsecond from the cycle counter and the timer
+  int64_t start_us = esp_timer_get_time();
+  uint32_t start_cycles = esp_cpu_get_cycle_count();
+  while (esp_timer_get_time() - start_us < WORKLOAD_CALIBRATION_US)
+    ;
+  uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+  int64_t elapsed_us = esp_timer_get_time() - start_us;
+  cycles_per_us = cycles / elapsed_us > 0 ? cycles / elapsed_us : 1;
+
+  for (WorkloadKernel kernel = 0; kernel < WORKLOAD_KERNELS; kernel++) {
+    // the first run warms up the caches, interrupts only slow a run down
+    uint32_t fastest = UINT32_MAX;
+    for (unsigned int run = 0; run <= WORKLOAD_CALIBRATION_RUNS; run++) {
+      uint32_t start = esp_cpu_get_cycle_count();
+      run_iterations(kernel, WORKLOAD_CALIBRATION_ITERATIONS);
+      uint32_t run_cycles = esp_cpu_get_cycle_count() - start;
+      if (run > 0 && run_cycles < fastest)
+        fastest = run_cycles;
+    }
+    uint64_t cost =
+        ((uint64_t)fastest << COST_SHIFT) / WORKLOAD_CALIBRATION_ITERATIONS;
+    iteration_cost[kernel] = cost > 0 ? cost : 1;
+    printf("Workload %s: %" PRIu32 ".%02" PRIu32 " cycles per iteration\n",
+           kernel_names[kernel], iteration_cost[kernel] >> COST_SHIFT,
+           ((iteration_cost[kernel] & ((1 << COST_SHIFT) - 1)) * 100) >>
+               COST_SHIFT);
+  }
+  printf("Workload: %" PRIu32 " cycles per microsecond\n", cycles_per_us);
+}
+
+uint64_t workload_ms_to_cycles(uint32_t ms) {
+  return (uint64_t)ms * 1000 * cycles_per_us;
+}
+
+void workload_run(WorkloadKernel kernel, uint64_t cycles) {
+  if (kernel >= WORKLOAD_KERNELS)
+    return;
+  uint64_t iterations = (cycles << COST_SHIFT) / iteration_cost[kernel];
+  while (iterations > 0) {
+    uint32_t chunk = iterations < UINT32_MAX ? iterations : UINT32_MAX;
+    run_iterations(kernel, chunk);
+    iterations -= chunk;
+  }
+}
@@ -0,0 +1,68 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// footprint of WORKLOAD_MEMORY in internal RAM
+#ifndef WORKLOAD_MEMORY_BYTES
+#define WORKLOAD_MEMORY_BYTES (16 * 1024)
+#endif
+// footprint of WORKLOAD_CACHE in flash, twice the flash cache of the ESP32
+#ifndef WORKLOAD_CACHE_BYTES
+#define WORKLOAD_CACHE_BYTES (64 * 1024)
+#endif
+#define WORKLOAD_CACHE_LINE 32
+// shortest execution time the distributions draw, in permille of the longest
+#ifndef WORKLOAD_BEST_CASE_PERMILLE
+#define WORKLOAD_BEST_CASE_PERMILLE 500
+#endif
+// the fastest of WORKLOAD_CALIBRATION_RUNS runs counts
+#define WORKLOAD_CALIBRATION_ITERATIONS 4096
+#define WORKLOAD_CALIBRATION_RUNS 8
+#define WORKLOAD_CALIBRATION_US 10000
+
+/* Synthetic load that executes a given number of CPU cycles (nanoseconds
+ * on the host). Every kernel repeats a short iteration whose cost
+ * workload_calibrate measures at boot, so a duration becomes an iteration
+ * count. The load is work, not time: a preempted kernel does not advance,
+ * and running it on both cores at once may make it slower than calibrated
+ * where they share the memory.
+ *
+ *   workload_calibrate();
+ *   ...
+ *   uint64_t cycles = workload_sample(WORKLOAD_UNIFORM,
+ *                                     workload_ms_to_cycles(wcet_ms), &seed);
+ *   workload_run(WORKLOAD_CPU, cycles);
+ */
+typedef enum {
+  WORKLOAD_CPU,    // dependent multiply-adds in registers
+  WORKLOAD_MEMORY, // copies a cache line worth of words in internal RAM
+  WORKLOAD_CACHE,  // reads a line of a flash table twice the cache size
+  WORKLOAD_KERNELS,
+} WorkloadKernel;
+
+/* Execution time of a job between WORKLOAD_BEST_CASE_PERMILLE of the
+ * longest one and the longest one. */
+typedef enum {
+  WORKLOAD_CONSTANT,   // always the longest
+  WORKLOAD_UNIFORM,    // every execution time equally likely
+  WORKLOAD_TRIANGULAR, // likeliest at the best case, falling linearly
+} WorkloadDistribution;
+
+/* Measure the cost of an iteration of every kernel and the CPU cycles per
+ * microsecond. Call once before any other function, while the load tasks
+ * do not run yet. */
+void workload_calibrate();
+
+uint64_t workload_ms_to_cycles(uint32_t ms);
+
+// execute 'cycles' CPU cycles of 'kernel', may be preempted
+void workload_run(WorkloadKernel kernel, uint64_t cycles);
+
+/* Draw the execution time of a job whose longest execution time is 'cycles'.
+ * Every task keeps its own 'seed', which makes the sequence repeatable. */
+uint64_t workload_sample(WorkloadDistribution distribution, uint64_t cycles,
+                         uint32_t *seed);
+
+#endif